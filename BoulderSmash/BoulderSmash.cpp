@@ -1,13 +1,19 @@
 #include "core/ECS.hpp"
 #include "core/Logger.hpp"
 #include "core/Input.hpp"
+#include "core/Time.hpp"
+#include "core/TransformHierarchy.hpp"
 #include "core/Window.hpp"
 #include "audio/SoundManager.hpp"
 #include "gameplay/AsteroidManager.hpp"
 #include "gameplay/Entity.hpp"
 #include "gameplay/EntityAsteroid.hpp"
 #include "lighting/PointLight.hpp"
+#include "physics/GravitySolver.hpp"
+#include "physics/PhysicsWorld.hpp"
+#include "physics/RigidBodySolver.hpp"
 #include "rendering/Camera.hpp"
+#include "rendering/GLState.hpp"
 #include "rendering/Renderer.hpp"
 #include "rendering/Model.hpp"
 #include "rendering/ShaderManager.hpp"
@@ -50,24 +56,49 @@ int main(void)
 
 	Skybox::GenerateSkybox(DEFAULT_CUBEMAP);
 
-	AsteroidManager::SpawnAsteroid(TRANSFORM_POSITION(0.0f, 0.0f, 10.0f), BoxCollider::Register(TRANSFORM_DEFAULT, glm::vec3{10.0f, 10.0f, 10.0f}, true), "asteroid");
+	SystemScheduler::RegisterSystem<ColliderSyncSystem>();
+
+	Prefab asteroidPrefab = AsteroidManager::CreateAsteroidPrefab(BoxCollider::Register(TRANSFORM_DEFAULT, glm::vec3{10.0f, 10.0f, 10.0f}, true, true), RigidBody::Register(50.0f, glm::vec3{ 0.0f }, glm::vec3{ 0.0f, 0.0f, 1.0f }), "asteroid");
+
+	AsteroidManager::SpawnAsteroids(asteroidPrefab, { TRANSFORM_POSITION(0.0f, 0.0f, 10.0f) });
+
+	Time::SetTickRate(60.0f);
+	RigidBodySolver::simulationRadius = 512.0f;
 
 	while (!Window::ShouldClose())
 	{
+		Time::BeginFrame();
+
 		Window::UpdateColors();
 
 		light->transform.position = camera->transform.position;
 
 		camera->Update();
+		PhysicsWorld::ClearCollisionEvents();
+		RigidBodySolver::focus = camera->transform.position;
+
+		while (Time::ShouldTick())
+		{
+			ECSManager::UpdateGameObjects();
+			PhysicsWorld::Step(Time::fixedDeltaTime);
+			GravitySolver::Step();
+			RigidBodySolver::Step(Time::fixedDeltaTime);
+		}
 		
+		TransformHierarchy::Update(Time::interpolation);
+
+		GLState::BeginFrame();
+
 		TextManager::UpdateRendering();
-		ECSManager::UpdateGameObjects();
 		Renderer::RenderObjects(camera);
 		Skybox::Render(camera);
+		Renderer::RenderTransparentObjects();
 
 		MainOverlay::RenderTime();
 		MainOverlay::UpdateTime();
 
+		ModelAssetManager::Collect();
+
 		Window::UpdateBuffers();
 	}
 
@@ -3,31 +3,49 @@
 
 #include "components/Transform.hpp"
 #include "core/ECS.hpp"
+#include "physics/AABB.hpp"
 
 struct BoxCollider : public Component
 {
+	struct Snapshot
+	{
+		bool useGameObject;
+		bool continuous;
+		std::uint32_t layer;
+		Transform transformThis;
+		glm::vec3 size;
+	};
+
+	Snapshot SaveSnapshot() const
+	{
+		return { useGameObject, continuous, layer, transformThis, size };
+	}
+
+	void LoadSnapshot(const Snapshot& snapshot)
+	{
+		useGameObject = snapshot.useGameObject;
+		continuous = snapshot.continuous;
+		layer = snapshot.layer;
+		transformThis = snapshot.transformThis;
+		size = snapshot.size;
+	}
+
 	bool useGameObject;
+	bool continuous = false;
+	std::uint32_t layer = 1;
 	Transform transformThis;
 	glm::vec3 size;
 
-	bool IsCollidingWith(BoxCollider other)
+	bool IsCollidingWith(const BoxCollider& other) const
 	{
-		glm::vec3 position;
-		glm::vec3 otherPosition;
-
-		if (useGameObject)
-			position = gameObject->transform.position;
-		else
-			position = transformThis.position;
+		return GetBounds().Overlaps(AABB::Register(other.transformThis.position, other.transformThis.position + other.size));
+	}
 
-		otherPosition = other.transformThis.position;
+	AABB GetBounds() const
+	{
+		glm::vec3 position = useGameObject ? gameObject->transform.position : transformThis.position;
 
-		return (position.x < otherPosition.x + other.size.x) &&
-			(position.x + size.x > otherPosition.x) &&
-			(position.y < otherPosition.y + other.size.y) &&
-			(position.y + size.y > otherPosition.y) &&
-			(position.z < otherPosition.z + other.size.z) &&
-			(position.z + size.z > otherPosition.z);
+		return AABB::Register(position, position + size);
 	}
 
 	BoxCollider operator==(BoxCollider other)
@@ -42,11 +60,12 @@ struct BoxCollider : public Component
 		return out;
 	}
 
-	static BoxCollider Register(const Transform& transform, const glm::vec3& size, const bool& useGameObject)
+	static BoxCollider Register(const Transform& transform, const glm::vec3& size, const bool& useGameObject, const bool& continuous = false)
 	{
 		BoxCollider collider;
 
 		collider.useGameObject = useGameObject;
+		collider.continuous = continuous;
 
 		collider.transformThis = transform;
 
@@ -56,4 +75,22 @@ struct BoxCollider : public Component
 	}
 };
 
+class ColliderSyncSystem : public ComponentSystem<ColliderSyncSystem, BoxCollider>
+{
+
+public:
+
+	ColliderSyncSystem()
+	{
+		Reads<Transform>();
+		Writes<BoxCollider>();
+	}
+
+	void UpdateEach(GameObject& gameObject, BoxCollider& collider)
+	{
+		if (collider.useGameObject)
+			collider.transformThis = gameObject.transform;
+	}
+};
+
 #endif // !BOX_COLLIDER_HPP
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef RIGID_BODY_HPP
+#define RIGID_BODY_HPP
+
+#include <glm/glm.hpp>
+#include "core/ECS.hpp"
+
+struct RigidBody : public Component
+{
+	struct Snapshot
+	{
+		float mass;
+		float restitution;
+		float linearDamping;
+		glm::vec3 linearVelocity;
+		glm::vec3 angularVelocity;
+		bool awake;
+		float sleepTime;
+	};
+
+	Snapshot SaveSnapshot() const
+	{
+		return { mass, restitution, linearDamping, linearVelocity, angularVelocity, awake, sleepTime };
+	}
+
+	void LoadSnapshot(const Snapshot& snapshot)
+	{
+		mass = snapshot.mass;
+		restitution = snapshot.restitution;
+		linearDamping = snapshot.linearDamping;
+		linearVelocity = snapshot.linearVelocity;
+		angularVelocity = snapshot.angularVelocity;
+		awake = snapshot.awake;
+		sleepTime = snapshot.sleepTime;
+	}
+
+	void ApplyImpulse(const glm::vec3& impulse)
+	{
+		linearVelocity += impulse / mass;
+		WakeUp();
+	}
+
+	void WakeUp()
+	{
+		awake = true;
+		sleepTime = 0.0f;
+	}
+
+	static RigidBody Register(float mass, const glm::vec3& linearVelocity, const glm::vec3& angularVelocity)
+	{
+		RigidBody body;
+
+		body.mass = mass;
+		body.linearVelocity = linearVelocity;
+		body.angularVelocity = angularVelocity;
+
+		return body;
+	}
+
+	float mass = 1.0f;
+	float restitution = 0.5f;
+	float linearDamping = 0.0f;
+
+	glm::vec3 linearVelocity = glm::vec3{ 0.0f };
+	glm::vec3 angularVelocity = glm::vec3{ 0.0f };
+
+	// Rewritten every tick by field solvers such as GravitySolver; not saved in snapshots.
+	glm::vec3 acceleration = glm::vec3{ 0.0f };
+
+	bool awake = true;
+	float sleepTime = 0.0f;
+
+	// The acceleration the body was under when it fell asleep; field solvers wake it only once that changes. Not saved in snapshots either.
+	glm::vec3 sleepAcceleration = glm::vec3{ 0.0f };
+};
+
+#endif // !RIGID_BODY_HPP
@@ -26,6 +26,16 @@ struct Transform
 		this->rotation = glm::quat{ rotation.w, this->rotation.x + rotation.x, this->rotation.y + rotation.y, this->rotation.z + rotation.z };
 	}
 
+	glm::mat4 ToMatrix() const
+	{
+		glm::mat4 matrix = glm::translate(glm::mat4(1.0f), position);
+
+		if (rotation.x != 0 || rotation.y != 0 || rotation.z != 0)
+			matrix = glm::rotate(matrix, rotation.w, glm::vec3{ rotation.x, rotation.y, rotation.z });
+
+		return matrix;
+	}
+
 	static Transform Register(const glm::vec3& position, const glm::quat& rotation)
 	{
 		Transform transform;
@@ -36,6 +46,16 @@ struct Transform
 		return transform;
 	}
 
+	static Transform Lerp(const Transform& from, const Transform& to, float alpha)
+	{
+		Transform transform = to;
+
+		transform.position = glm::mix(from.position, to.position, alpha);
+		transform.rotation = glm::quat{ glm::mix(from.rotation.w, to.rotation.w, alpha), glm::mix(from.rotation.x, to.rotation.x, alpha), glm::mix(from.rotation.y, to.rotation.y, alpha), glm::mix(from.rotation.z, to.rotation.z, alpha) };
+
+		return transform;
+	}
+
 	glm::quat rotation;
 	glm::vec3 position;
 	glm::vec3 up;
@@ -5,16 +5,190 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
-#include <bitset>
 #include <array>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <type_traits>
 #include "components/Transform.hpp"
+#include "core/Logger.hpp"
+#include "threading/ThreadPool.hpp"
+#include "utils/PoolAllocator.hpp"
 
-#define maxComponents 32
+#define entityIndexBits 20
+#define entityIndexMask ((1u << entityIndexBits) - 1)
+#define entityGenerationMask ((1u << (32 - entityIndexBits)) - 1)
+#define nullEntity 0xFFFFFFFFu
 
 class Component;
 class GameObject;
 
 typedef std::size_t ComponentID;
+typedef std::uint64_t ComponentTypeHash;
+typedef std::uint32_t EntityID;
+
+inline std::uint32_t GetEntityIndex(EntityID id)
+{
+	return id & entityIndexMask;
+}
+
+inline std::uint32_t GetEntityGeneration(EntityID id)
+{
+	return id >> entityIndexBits;
+}
+
+// Grows one 64-bit word at a time, so there is no fixed limit on the number of component types.
+class ComponentBitset
+{
+
+public:
+
+	bool operator[](std::size_t bit) const
+	{
+		std::size_t word = bit / 64;
+
+		return word < words.size() && (words[word] >> (bit % 64)) & 1;
+	}
+
+	ComponentBitset& set(std::size_t bit)
+	{
+		std::size_t word = bit / 64;
+
+		if (words.size() <= word)
+			words.resize(word + 1, 0);
+
+		words[word] |= std::uint64_t(1) << (bit % 64);
+
+		return *this;
+	}
+
+	ComponentBitset& reset(std::size_t bit)
+	{
+		std::size_t word = bit / 64;
+
+		if (word < words.size())
+		{
+			words[word] &= ~(std::uint64_t(1) << (bit % 64));
+
+			while (!words.empty() && words.back() == 0)
+				words.pop_back();
+		}
+
+		return *this;
+	}
+
+	bool any() const
+	{
+		return !words.empty();
+	}
+
+	std::size_t size() const
+	{
+		return words.size() * 64;
+	}
+
+	bool Contains(const ComponentBitset& other) const
+	{
+		if (other.words.size() > words.size())
+			return false;
+
+		for (std::size_t w = 0; w < other.words.size(); ++w)
+		{
+			if ((words[w] & other.words[w]) != other.words[w])
+				return false;
+		}
+
+		return true;
+	}
+
+	bool Intersects(const ComponentBitset& other) const
+	{
+		std::size_t count = std::min(words.size(), other.words.size());
+
+		for (std::size_t w = 0; w < count; ++w)
+		{
+			if (words[w] & other.words[w])
+				return true;
+		}
+
+		return false;
+	}
+
+	bool operator==(const ComponentBitset& other) const
+	{
+		return words == other.words;
+	}
+
+	std::size_t Hash() const
+	{
+		std::size_t hash = 0;
+
+		for (std::uint64_t word : words)
+			hash = hash * 31 + std::hash<std::uint64_t>{}(word);
+
+		return hash;
+	}
+
+private:
+
+	std::vector<std::uint64_t> words;
+};
+
+template<>
+struct std::hash<ComponentBitset>
+{
+	std::size_t operator()(const ComponentBitset& bitset) const
+	{
+		return bitset.Hash();
+	}
+};
+
+// FNV-1a over the compiler's signature for this instantiation, so the hash is fixed at compile time and does not depend on registration order.
+template<typename T>
+constexpr ComponentTypeHash GetComponentTypeHash()
+{
+#if defined(_MSC_VER)
+	const char* signature = __FUNCSIG__;
+#else
+	const char* signature = __PRETTY_FUNCTION__;
+#endif
+
+	ComponentTypeHash hash = 14695981039346656037ull;
+
+	for (const char* c = signature; *c; ++c)
+	{
+		hash ^= static_cast<unsigned char>(*c);
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
+
+struct ComponentTypeInfo
+{
+	ComponentTypeHash hash;
+	std::size_t size;
+	std::size_t alignment;
+
+	void (*moveConstruct)(void* destination, void* source);
+	void (*copyConstruct)(void* destination, const void* source);
+	void (*destruct)(void* component);
+	std::size_t (*update)(void* components, std::size_t count, const std::uint32_t& version);
+	Component* (*asComponent)(void* component);
+
+	std::size_t snapshotSize;
+	void (*saveSnapshot)(void* component, void* out);
+	void (*loadSnapshot)(void* destination, const void* in);
+};
+
+std::vector<ComponentTypeInfo> componentTypeInfos;
+std::unordered_map<ComponentTypeHash, ComponentID> componentTypeLookup;
+
+// A type can be seen for the first time inside a system job, so registration is serialized. Everything else that reads the
+// registry makes structural changes, which only happen on the main thread outside parallel jobs.
+std::mutex componentTypeMutex;
 
 inline ComponentID GetComponentTypeID()
 {
@@ -22,22 +196,116 @@ inline ComponentID GetComponentTypeID()
 	return lastID++;
 }
 
-template<typename T> 
+template<typename T>
+inline ComponentID RegisterComponentType()
+{
+	constexpr ComponentTypeHash hash = GetComponentTypeHash<T>();
+
+	std::lock_guard<std::mutex> lock(componentTypeMutex);
+
+	auto found = componentTypeLookup.find(hash);
+
+	if (found != componentTypeLookup.end())
+		return found->second;
+
+	ComponentTypeInfo info;
+
+	info.hash = hash;
+	info.size = sizeof(T);
+	info.alignment = alignof(T);
+	info.moveConstruct = [](void* destination, void* source) { new (destination) T(std::move(*static_cast<T*>(source))); };
+	info.destruct = [](void* component) { static_cast<T*>(component)->~T(); };
+
+	if constexpr (std::is_copy_constructible_v<T>)
+		info.copyConstruct = [](void* destination, const void* source) { new (destination) T(*static_cast<const T*>(source)); };
+	else
+		info.copyConstruct = nullptr;
+	info.asComponent = [](void* component) -> Component* { return static_cast<T*>(component); };
+
+	if constexpr (std::is_same_v<decltype(&T::Update), void (Component::*)()>)
+		info.update = nullptr;
+	else
+	{
+		// Stops after any Update that moved the archetype's version, since the storage being walked may have moved with it.
+		info.update = [](void* components, std::size_t count, const std::uint32_t& version) -> std::size_t
+		{
+			T* typed = static_cast<T*>(components);
+			std::uint32_t expected = version;
+
+			for (std::size_t c = 0; c < count; ++c)
+			{
+				typed[c].T::Update();
+
+				if (version != expected)
+					return c + 1;
+			}
+
+			return count;
+		};
+	}
+
+	// Components opt into world snapshots by declaring a trivially copyable Snapshot struct with SaveSnapshot and LoadSnapshot.
+	if constexpr (requires { typename T::Snapshot; })
+	{
+		using Snapshot = typename T::Snapshot;
+
+		static_assert(std::is_trivially_copyable_v<Snapshot>, "Component snapshots must be trivially copyable");
+
+		info.snapshotSize = sizeof(Snapshot);
+		info.saveSnapshot = [](void* component, void* out)
+		{
+			Snapshot snapshot = static_cast<T*>(component)->SaveSnapshot();
+			std::memcpy(out, &snapshot, sizeof(Snapshot));
+		};
+		info.loadSnapshot = [](void* destination, const void* in)
+		{
+			Snapshot snapshot;
+			std::memcpy(&snapshot, in, sizeof(Snapshot));
+
+			static_cast<T*>(new (destination) T())->LoadSnapshot(snapshot);
+		};
+	}
+	else
+	{
+		info.snapshotSize = 0;
+		info.saveSnapshot = nullptr;
+		info.loadSnapshot = nullptr;
+	}
+
+	ComponentID id = GetComponentTypeID();
+
+	if (componentTypeInfos.size() <= id)
+		componentTypeInfos.resize(id + 1);
+
+	componentTypeInfos[id] = info;
+	componentTypeLookup[hash] = id;
+
+	return id;
+}
+
+// ComponentIDs index bitsets and columns inside this process only; anything saved or sent elsewhere should use the hash.
+inline ComponentID GetComponentTypeIDFromHash(ComponentTypeHash hash)
+{
+	std::lock_guard<std::mutex> lock(componentTypeMutex);
+
+	auto found = componentTypeLookup.find(hash);
+
+	return found != componentTypeLookup.end() ? found->second : static_cast<ComponentID>(-1);
+}
+
+template<typename T>
 inline ComponentID GetComponentTypeID() noexcept
 {
-	static ComponentID typeID = GetComponentTypeID();
+	static ComponentID typeID = RegisterComponentType<T>();
 	return typeID;
 }
 
-using ComponentBitset = std::bitset<maxComponents>;
-using ComponentArray = std::array<Component*, maxComponents>;
-
 class Component
 {
-	
+
 public:
 
-	GameObject* gameObject;
+	GameObject* gameObject = nullptr;
 
 	virtual void Start() {}
 	virtual void Update() {}
@@ -45,92 +313,1580 @@ public:
 	virtual ~Component() {}
 };
 
-class GameObject
+class ComponentColumn
 {
 
 public:
 
-	void Update()
+	ComponentColumn(ComponentID id) : id(id), info(componentTypeInfos[id]) { }
+
+	ComponentColumn(ComponentColumn&& other) noexcept : id(other.id), info(other.info), data(other.data), count(other.count), capacity(other.capacity)
 	{
-		for (auto& component : components)
-		{
-			component->Update();
-		}
+		other.data = nullptr;
+		other.count = 0;
+		other.capacity = 0;
+	}
+
+	ComponentColumn(const ComponentColumn&) = delete;
+	ComponentColumn& operator=(const ComponentColumn&) = delete;
+
+	~ComponentColumn()
+	{
+		for (std::size_t c = 0; c < count; ++c)
+			info.destruct(Get(c));
+
+		AllocationCounter::Deallocate(data, info.alignment);
+	}
+
+	void* Get(std::size_t row)
+	{
+		return data + row * info.size;
+	}
+
+	const void* Get(std::size_t row) const
+	{
+		return data + row * info.size;
 	}
 
 	template<typename T>
-	bool HasComponent()
+	T* Data()
 	{
-		return bitset[GetComponentTypeID<T>()];
+		return reinterpret_cast<T*>(data);
 	}
 
-	template<typename T, typename... TArgs>
-	T& AddComponent(TArgs&&... args)
+	void* Allocate()
 	{
-		T* component(new T(std::forward<TArgs>(args)...));
-		component->gameObject = this;
+		if (count == capacity)
+			Reserve(capacity == 0 ? 16 : capacity * 2);
 
-		std::unique_ptr<Component> componentPtr{ component };
-		components.emplace_back(std::move(componentPtr));
+		return Get(count++);
+	}
 
-		array[GetComponentTypeID<T>()] = component;
-		bitset[GetComponentTypeID<T>()] = true;
+	void EmplaceFrom(void* source)
+	{
+		info.moveConstruct(Allocate(), source);
+	}
 
-		component->Start();
+	// Appends count copies of source after growing the column at most once.
+	void EmplaceCopies(const void* source, std::size_t count)
+	{
+		Reserve(this->count + count);
 
-		return *component;
+		for (std::size_t c = 0; c < count; ++c)
+			info.copyConstruct(Get(this->count++), source);
 	}
 
-	template<typename T>
-	T& GetComponent()
+	// Appends count rows built from tightly packed Snapshot structs after growing the column at most once.
+	void EmplaceSnapshots(const unsigned char* snapshots, std::size_t count)
 	{
-		auto componentPtr(array[GetComponentTypeID<T>()]);
+		Reserve(this->count + count);
 
-		return *static_cast<T*>(componentPtr);
+		for (std::size_t c = 0; c < count; ++c)
+			info.loadSnapshot(Get(this->count++), snapshots + c * info.snapshotSize);
 	}
 
-	bool active = true;
-	Transform transform;
+	void SwapRemove(std::size_t row)
+	{
+		std::size_t last = count - 1;
+
+		info.destruct(Get(row));
+
+		if (row != last)
+		{
+			info.moveConstruct(Get(row), Get(last));
+			info.destruct(Get(last));
+		}
+
+		count--;
+	}
+
+	void Reserve(std::size_t newCapacity)
+	{
+		if (newCapacity <= capacity)
+			return;
+
+		unsigned char* newData = static_cast<unsigned char*>(AllocationCounter::Allocate(newCapacity * info.size, info.alignment));
+
+		for (std::size_t c = 0; c < count; ++c)
+		{
+			info.moveConstruct(newData + c * info.size, Get(c));
+			info.destruct(Get(c));
+		}
+
+		AllocationCounter::Deallocate(data, info.alignment);
+
+		data = newData;
+		capacity = newCapacity;
+	}
+
+	bool HasUpdate() const
+	{
+		return info.update != nullptr;
+	}
+
+	// Updates every row until one changes version; returns how many rows were updated.
+	std::size_t Update(const std::uint32_t& version)
+	{
+		return info.update(data, count, version);
+	}
+
+	void UpdateRow(std::size_t row)
+	{
+		std::uint32_t version = 0;
+
+		info.update(Get(row), 1, version);
+	}
+
+	ComponentID id;
 
 private:
 
-	std::vector<std::unique_ptr<Component>> components;
+	ComponentTypeInfo info;
 
-	ComponentArray array;
-	ComponentBitset bitset;
+	unsigned char* data = nullptr;
+	std::size_t count = 0;
+	std::size_t capacity = 0;
 };
 
-class ECSManager
+class Archetype;
+
+class EntityQuery
 {
 
 public:
 
-	static GameObject& AddGameObject()
+	EntityQuery(const ComponentBitset& mask) : mask(mask) { }
+
+	bool Matches(const Archetype* archetype) const;
+
+	void Add(EntityID id, GameObject* gameObject)
 	{
-		GameObject* gameObject = new GameObject();
-		std::unique_ptr<GameObject> gameObjectPtr{ gameObject };
+		std::uint32_t index = GetEntityIndex(id);
 
-		gameObjects.emplace_back(std::move(gameObjectPtr));
+		if (sparse.size() <= index)
+			sparse.resize(index + 1);
 
-		return *gameObject;
+		sparse[index] = static_cast<std::uint32_t>(gameObjects.size());
+		entities.push_back(id);
+		gameObjects.push_back(gameObject);
 	}
 
-	static void UpdateGameObjects()
+	void Remove(EntityID id)
 	{
-		gameObjects.erase(std::remove_if(std::begin(gameObjects), std::end(gameObjects), [](const std::unique_ptr<GameObject>& gameobject) { return !gameobject->active; }), std::end(gameObjects));
-		
-		for (auto& gameObject : gameObjects)
+		std::uint32_t slot = sparse[GetEntityIndex(id)];
+		std::size_t last = entities.size() - 1;
+
+		if (slot != last)
 		{
-			gameObject->Update();
+			entities[slot] = entities[last];
+			gameObjects[slot] = gameObjects[last];
+			sparse[GetEntityIndex(entities[slot])] = slot;
 		}
+
+		entities.pop_back();
+		gameObjects.pop_back();
 	}
 
+	ComponentBitset mask;
+	std::vector<EntityID> entities;
+	std::vector<GameObject*> gameObjects;
+	std::vector<Archetype*> archetypes;
+
 private:
 
-	static std::vector<std::unique_ptr<GameObject>> gameObjects;
+	std::vector<std::uint32_t> sparse;
+};
+
+class Archetype
+{
+
+public:
+
+	Archetype(const ComponentBitset& signature) : signature(signature)
+	{
+		columnIndices.resize(signature.size(), -1);
+
+		for (ComponentID id = 0; id < signature.size(); ++id)
+		{
+			if (!signature[id])
+				continue;
+
+			columnIndices[id] = static_cast<int>(columns.size());
+			columns.emplace_back(id);
+		}
+	}
+
+	bool HasColumn(ComponentID id) const
+	{
+		return id < columnIndices.size() && columnIndices[id] != -1;
+	}
+
+	ComponentColumn& GetColumn(ComponentID id)
+	{
+		return columns[columnIndices[id]];
+	}
+
+	std::size_t AddRow(EntityID id, GameObject* gameObject)
+	{
+		version++;
+		entities.push_back(id);
+		gameObjects.push_back(gameObject);
+		return gameObjects.size() - 1;
+	}
+
+	GameObject* RemoveRow(std::size_t row)
+	{
+		version++;
+
+		for (auto& column : columns)
+			column.SwapRemove(row);
+
+		std::size_t last = gameObjects.size() - 1;
+		GameObject* moved = nullptr;
+
+		if (row != last)
+		{
+			entities[row] = entities[last];
+			gameObjects[row] = gameObjects[last];
+			moved = gameObjects[row];
+		}
+
+		entities.pop_back();
+		gameObjects.pop_back();
+
+		return moved;
+	}
+
+	std::size_t GetCount() const
+	{
+		return gameObjects.size();
+	}
+
+	ComponentBitset signature;
+	std::vector<ComponentColumn> columns;
+	std::vector<EntityID> entities;
+	std::vector<GameObject*> gameObjects;
+	std::vector<EntityQuery*> queries;
+	std::vector<Archetype*> addEdges;
+	std::vector<Archetype*> removeEdges;
+
+	// Moves whenever a row is added or removed, which is whenever the columns may have reallocated or swapped rows.
+	std::uint32_t version = 0;
+
+private:
 
+	std::vector<int> columnIndices;
 };
 
-std::vector<std::unique_ptr<GameObject>> ECSManager::gameObjects;
+bool EntityQuery::Matches(const Archetype* archetype) const
+{
+	return archetype && archetype->signature.Contains(mask);
+}
+
+namespace ArchetypeManager
+{
+	extern std::vector<std::unique_ptr<Archetype>> archetypes;
+	extern std::unordered_map<ComponentBitset, Archetype*> archetypeLookup;
+	extern std::vector<std::unique_ptr<EntityQuery>> queries;
+	extern std::unordered_map<ComponentBitset, EntityQuery*> queryLookup;
+
+	Archetype& GetArchetype(const ComponentBitset& signature)
+	{
+		auto found = archetypeLookup.find(signature);
+
+		if (found != archetypeLookup.end())
+			return *found->second;
+
+		archetypes.emplace_back(std::make_unique<Archetype>(signature));
+		archetypeLookup[signature] = archetypes.back().get();
+
+		Archetype& archetype = *archetypes.back();
+
+		for (auto& query : queries)
+		{
+			if (query->Matches(&archetype))
+			{
+				query->archetypes.push_back(&archetype);
+				archetype.queries.push_back(query.get());
+			}
+		}
+
+		return archetype;
+	}
+
+	// Builds the query's entity list once; afterwards MoveEntity keeps it current as entities change archetype.
+	EntityQuery& GetQuery(const ComponentBitset& mask)
+	{
+		auto found = queryLookup.find(mask);
+
+		if (found != queryLookup.end())
+			return *found->second;
+
+		queries.emplace_back(std::make_unique<EntityQuery>(mask));
+		queryLookup[mask] = queries.back().get();
+
+		EntityQuery& query = *queries.back();
+
+		for (auto& archetype : archetypes)
+		{
+			if (!query.Matches(archetype.get()))
+				continue;
+
+			query.archetypes.push_back(archetype.get());
+			archetype->queries.push_back(&query);
+
+			for (std::size_t r = 0; r < archetype->GetCount(); ++r)
+				query.Add(archetype->entities[r], archetype->gameObjects[r]);
+		}
+
+		return query;
+	}
+
+	void MoveEntity(EntityID id, GameObject* gameObject, Archetype* from, Archetype* to)
+	{
+		if (from)
+		{
+			for (EntityQuery* query : from->queries)
+			{
+				if (!query->Matches(to))
+					query->Remove(id);
+			}
+		}
+
+		if (to)
+		{
+			for (EntityQuery* query : to->queries)
+			{
+				if (!query->Matches(from))
+					query->Add(id, gameObject);
+			}
+		}
+	}
+
+	Archetype& GetAddTarget(Archetype& archetype, ComponentID id)
+	{
+		if (archetype.addEdges.size() <= id)
+			archetype.addEdges.resize(id + 1, nullptr);
+
+		if (!archetype.addEdges[id])
+		{
+			ComponentBitset signature = archetype.signature;
+			signature.set(id);
+
+			archetype.addEdges[id] = &GetArchetype(signature);
+		}
+
+		return *archetype.addEdges[id];
+	}
+
+	Archetype& GetRemoveTarget(Archetype& archetype, ComponentID id)
+	{
+		if (archetype.removeEdges.size() <= id)
+			archetype.removeEdges.resize(id + 1, nullptr);
+
+		if (!archetype.removeEdges[id])
+		{
+			ComponentBitset signature = archetype.signature;
+			signature.reset(id);
+
+			archetype.removeEdges[id] = &GetArchetype(signature);
+		}
+
+		return *archetype.removeEdges[id];
+	}
+}
+
+std::vector<std::unique_ptr<Archetype>> ArchetypeManager::archetypes;
+std::unordered_map<ComponentBitset, Archetype*> ArchetypeManager::archetypeLookup;
+std::vector<std::unique_ptr<EntityQuery>> ArchetypeManager::queries;
+std::unordered_map<ComponentBitset, EntityQuery*> ArchetypeManager::queryLookup;
+
+class GameObject
+{
+
+public:
+
+	GameObject(EntityID id) : GameObject(id, ArchetypeManager::GetArchetype(ComponentBitset{})) { }
+
+	// Joins archetype directly; every column must already hold this GameObject's components in the row it is about to take.
+	GameObject(EntityID id, Archetype& archetype) : id(id), archetype(&archetype)
+	{
+		row = archetype.AddRow(id, this);
+
+		ArchetypeManager::MoveEntity(id, this, nullptr, &archetype);
+
+		hierarchyChanged = true;
+	}
+
+	~GameObject()
+	{
+		SetParent(nullptr);
+
+		for (GameObject* child : children)
+			child->parent = nullptr;
+
+		hierarchyChanged = true;
+
+		ArchetypeManager::MoveEntity(id, this, archetype, nullptr);
+
+		GameObject* moved = archetype->RemoveRow(row);
+
+		if (moved)
+			moved->row = row;
+	}
+
+	GameObject(const GameObject&) = delete;
+	GameObject& operator=(const GameObject&) = delete;
+
+	EntityID GetID() const
+	{
+		return id;
+	}
+
+	template<typename T>
+	bool HasComponent()
+	{
+		return HasComponent(GetComponentTypeID<T>());
+	}
+
+	bool HasComponent(ComponentID id) const
+	{
+		return archetype->signature[id];
+	}
+
+	template<typename T, typename... TArgs>
+	T& AddComponent(TArgs&&... args)
+	{
+		T component(std::forward<TArgs>(args)...);
+
+		return static_cast<T&>(AddComponent(GetComponentTypeID<T>(), &component));
+	}
+
+	// Moves the component at source into this GameObject, replacing any existing component of the same type.
+	Component& AddComponent(ComponentID id, void* source)
+	{
+		const ComponentTypeInfo& info = componentTypeInfos[id];
+
+		if (HasComponent(id))
+		{
+			void* existing = archetype->GetColumn(id).Get(row);
+
+			info.destruct(existing);
+			info.moveConstruct(existing, source);
+		}
+		else
+		{
+			Archetype& target = ArchetypeManager::GetAddTarget(*archetype, id);
+
+			target.GetColumn(id).EmplaceFrom(source);
+			MoveTo(target);
+		}
+
+		GetComponent(id).gameObject = this;
+		GetComponent(id).Start();
+
+		return GetComponent(id);
+	}
+
+	template<typename T>
+	void RemoveComponent()
+	{
+		RemoveComponent(GetComponentTypeID<T>());
+	}
+
+	void RemoveComponent(ComponentID id)
+	{
+		if (HasComponent(id))
+			MoveTo(ArchetypeManager::GetRemoveTarget(*archetype, id));
+	}
+
+	template<typename T>
+	T& GetComponent()
+	{
+		return *static_cast<T*>(archetype->GetColumn(GetComponentTypeID<T>()).Get(row));
+	}
+
+	Component& GetComponent(ComponentID id)
+	{
+		return *componentTypeInfos[id].asComponent(GetComponentData(id));
+	}
+
+	void* GetComponentData(ComponentID id)
+	{
+		return archetype->GetColumn(id).Get(row);
+	}
+
+	void UpdateComponent(ComponentID id)
+	{
+		archetype->GetColumn(id).UpdateRow(row);
+	}
+
+	// Attaches this GameObject under parent so its transform is treated as local to the parent; nullptr detaches it.
+	void SetParent(GameObject* parent)
+	{
+		if (parent == this->parent)
+			return;
+
+		for (GameObject* ancestor = parent; ancestor; ancestor = ancestor->parent)
+		{
+			if (ancestor == this)
+			{
+				Logger_WriteConsole("Cannot parent a GameObject to one of its own children", LogLevel::WARNING);
+				return;
+			}
+		}
+
+		if (this->parent)
+		{
+			std::vector<GameObject*>& siblings = this->parent->children;
+			siblings.erase(std::find(siblings.begin(), siblings.end(), this));
+		}
+
+		this->parent = parent;
+
+		if (parent)
+			parent->children.push_back(this);
+
+		hierarchyChanged = true;
+	}
+
+	GameObject* GetParent() const
+	{
+		return parent;
+	}
+
+	const std::vector<GameObject*>& GetChildren() const
+	{
+		return children;
+	}
+
+	// Places the GameObject without interpolating from its last simulated transform.
+	void Teleport(const Transform& transform)
+	{
+		this->transform = transform;
+		previousTransform = transform;
+	}
+
+	bool active = true;
+	Transform transform = TRANSFORM_DEFAULT;
+	Transform previousTransform = TRANSFORM_DEFAULT;
+
+private:
+
+	void MoveTo(Archetype& target)
+	{
+		for (auto& column : archetype->columns)
+		{
+			if (target.HasColumn(column.id))
+				target.GetColumn(column.id).EmplaceFrom(column.Get(row));
+		}
+
+		std::size_t newRow = target.AddRow(id, this);
+		GameObject* moved = archetype->RemoveRow(row);
+
+		if (moved)
+			moved->row = row;
+
+		ArchetypeManager::MoveEntity(id, this, archetype, &target);
+
+		archetype = &target;
+		row = newRow;
+	}
+
+	friend class TransformHierarchy;
+
+	EntityID id;
+	Archetype* archetype;
+	std::size_t row;
+
+	GameObject* parent = nullptr;
+	std::vector<GameObject*> children;
+	std::int32_t hierarchyIndex = -1;
+
+	static bool hierarchyChanged;
+};
+
+bool GameObject::hierarchyChanged = true;
+
+class System
+{
+
+public:
+
+	virtual ~System() {}
+
+	virtual void UpdateChunk(Archetype& archetype, std::size_t begin, std::size_t end) = 0;
+
+	template<typename... Ts>
+	void Reads()
+	{
+		(Declare<Ts>(reads, readsTransform), ...);
+	}
+
+	template<typename... Ts>
+	void Writes()
+	{
+		(Declare<Ts>(writes, writesTransform), ...);
+	}
+
+	bool ConflictsWith(const System& other) const
+	{
+		if (writes.Intersects(other.reads) || writes.Intersects(other.writes) || other.writes.Intersects(reads))
+			return true;
+
+		return (writesTransform && (other.readsTransform || other.writesTransform)) || (other.writesTransform && readsTransform);
+	}
+
+	ComponentBitset queryMask;
+	EntityQuery* query = nullptr;
+	std::uint32_t index = 0;
+
+private:
+
+	template<typename T>
+	void Declare(ComponentBitset& bitset, bool& transformFlag)
+	{
+		if constexpr (std::is_same_v<T, Transform>)
+			transformFlag = true;
+		else
+			bitset.set(GetComponentTypeID<T>());
+	}
+
+	ComponentBitset reads;
+	ComponentBitset writes;
+	bool readsTransform = false;
+	bool writesTransform = false;
+};
+
+template<typename Derived, typename... Ts>
+class ComponentSystem : public System
+{
+
+public:
+
+	ComponentSystem()
+	{
+		(queryMask.set(GetComponentTypeID<Ts>()), ...);
+	}
+
+	void UpdateChunk(Archetype& archetype, std::size_t begin, std::size_t end) override
+	{
+		UpdateRange(archetype.gameObjects.data(), begin, end, archetype.GetColumn(GetComponentTypeID<Ts>()).template Data<Ts>()...);
+	}
+
+private:
+
+	void UpdateRange(GameObject** gameObjects, std::size_t begin, std::size_t end, Ts*... components)
+	{
+		Derived& self = static_cast<Derived&>(*this);
+
+		for (std::size_t r = begin; r < end; ++r)
+			self.UpdateEach(*gameObjects[r], components[r]...);
+	}
+};
+
+template<typename... Ts>
+class View
+{
+
+public:
+
+	View(EntityQuery& query) : query(&query) { }
+
+	std::size_t Size() const
+	{
+		return query->gameObjects.size();
+	}
+
+	const std::vector<EntityID>& GetEntities() const
+	{
+		return query->entities;
+	}
+
+	GameObject** begin() const
+	{
+		return query->gameObjects.data();
+	}
+
+	GameObject** end() const
+	{
+		return query->gameObjects.data() + query->gameObjects.size();
+	}
+
+	// Walks the matching archetypes' columns directly rather than resolving each entity's components.
+	template<typename Function>
+	void Each(Function&& function) const
+	{
+		for (Archetype* archetype : query->archetypes)
+			EachInArchetype(archetype->GetCount(), function, archetype->GetColumn(GetComponentTypeID<Ts>()).template Data<Ts>()...);
+	}
+
+private:
+
+	template<typename Function>
+	static void EachInArchetype(std::size_t count, Function& function, Ts*... components)
+	{
+		for (std::size_t c = 0; c < count; ++c)
+			function(components[c]...);
+	}
+
+	EntityQuery* query;
+};
+
+struct SystemChunk
+{
+	System* system;
+	Archetype* archetype;
+	std::size_t begin;
+	std::size_t end;
+	std::uint32_t origin;
+};
+
+// Where the commands this thread records come from: chunk is 0 outside systems, otherwise the SystemChunk::origin being run.
+// A chunk runs start to finish on one thread, so chunk and recorded together order commands the same way whichever thread ran it.
+struct CommandOrigin
+{
+	std::uint32_t chunk = 0;
+	std::uint32_t recorded = 0;
+
+	static CommandOrigin& GetCurrent()
+	{
+		thread_local CommandOrigin origin;
+		return origin;
+	}
+};
+
+class SystemScheduler
+{
+
+public:
+
+	template<typename T, typename... TArgs>
+	static T& RegisterSystem(TArgs&&... args)
+	{
+		systems.emplace_back(std::make_unique<T>(std::forward<TArgs>(args)...));
+		systems.back()->index = static_cast<std::uint32_t>(systems.size() - 1);
+
+		BuildStages();
+
+		return static_cast<T&>(*systems.back());
+	}
+
+	static void Update()
+	{
+		if (singleThreaded)
+		{
+			for (auto& system : systems)
+			{
+				chunks.clear();
+				AppendChunks(*system);
+
+				for (auto& chunk : chunks)
+					RunChunk(chunk);
+			}
+
+			return;
+		}
+
+		for (auto& stage : stages)
+		{
+			chunks.clear();
+
+			for (System* system : stage)
+				AppendChunks(*system);
+
+			threadPool.Dispatch(chunks.size(), [](std::size_t c)
+			{
+				RunChunk(chunks[c]);
+			});
+		}
+	}
+
+	// Shared with other engine code that fans work out across cores; must not be used from inside a running system.
+	static ThreadPool& GetThreadPool()
+	{
+		return threadPool;
+	}
+
+	static bool singleThreaded;
+	static std::size_t chunkSize;
+
+private:
+
+	// Each system goes in the stage after the last one holding a system it conflicts with, so conflicting systems keep their registration order.
+	static void BuildStages()
+	{
+		stages.clear();
+
+		for (auto& system : systems)
+		{
+			std::size_t stage = 0;
+
+			for (std::size_t s = 0; s < stages.size(); ++s)
+			{
+				for (System* other : stages[s])
+				{
+					if (system->ConflictsWith(*other))
+						stage = s + 1;
+				}
+			}
+
+			if (stage == stages.size())
+				stages.emplace_back();
+
+			stages[stage].push_back(system.get());
+		}
+	}
+
+	// Origins number chunks by system registration order, then by position within the system, so they do not depend on staging.
+	static void AppendChunks(System& system)
+	{
+		if (!system.query)
+			system.query = &ArchetypeManager::GetQuery(system.queryMask);
+
+		std::uint32_t origin = (system.index + 1) << 16;
+
+		for (Archetype* archetype : system.query->archetypes)
+		{
+			std::size_t count = archetype->GetCount();
+
+			for (std::size_t begin = 0; begin < count; begin += chunkSize)
+				chunks.push_back({ &system, archetype, begin, std::min(begin + chunkSize, count), origin++ });
+		}
+	}
+
+	static void RunChunk(SystemChunk& chunk)
+	{
+		CommandOrigin& current = CommandOrigin::GetCurrent();
+		CommandOrigin outside = current;
+
+		current = { chunk.origin, 0 };
+
+		chunk.system->UpdateChunk(*chunk.archetype, chunk.begin, chunk.end);
+
+		current = outside;
+	}
+
+	static std::vector<std::unique_ptr<System>> systems;
+	static std::vector<std::vector<System*>> stages;
+	static std::vector<SystemChunk> chunks;
+	static ThreadPool threadPool;
+};
+
+std::vector<std::unique_ptr<System>> SystemScheduler::systems;
+std::vector<std::vector<System*>> SystemScheduler::stages;
+std::vector<SystemChunk> SystemScheduler::chunks;
+bool SystemScheduler::singleThreaded = false;
+std::size_t SystemScheduler::chunkSize = 4096;
+
+enum class EntityCommandType
+{
+	SPAWN,
+	ADD_COMPONENT,
+	REMOVE_COMPONENT,
+	DESTROY
+};
+
+struct PendingEntity
+{
+	std::uint32_t index;
+};
+
+struct EntityCommand
+{
+	EntityCommandType type;
+	EntityID entity;
+	std::uint32_t pending;
+	std::uint64_t sequence;
+	ComponentID component;
+	void* payload;
+};
+
+// Records structural changes so they can be made from inside systems and applied later by ECSManager::PlaybackCommandBuffers.
+class EntityCommandBuffer
+{
+
+public:
+
+	EntityCommandBuffer() = default;
+	EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+	EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+	~EntityCommandBuffer()
+	{
+		Clear();
+
+		for (auto& block : blocks)
+			AllocationCounter::Deallocate(block.data, blockAlignment);
+	}
+
+	PendingEntity Spawn(const Transform& transform = TRANSFORM_DEFAULT)
+	{
+		PendingEntity pending{ static_cast<std::uint32_t>(spawnTransforms.size()) };
+
+		spawnTransforms.push_back(transform);
+		Record(EntityCommandType::SPAWN, nullEntity, pending.index, 0, nullptr);
+
+		return pending;
+	}
+
+	template<typename T, typename... TArgs>
+	void AddComponent(EntityID entity, TArgs&&... args)
+	{
+		Record(EntityCommandType::ADD_COMPONENT, entity, nullEntity, GetComponentTypeID<T>(), new (AllocatePayload(sizeof(T), alignof(T))) T(std::forward<TArgs>(args)...));
+	}
+
+	template<typename T, typename... TArgs>
+	void AddComponent(PendingEntity entity, TArgs&&... args)
+	{
+		Record(EntityCommandType::ADD_COMPONENT, nullEntity, entity.index, GetComponentTypeID<T>(), new (AllocatePayload(sizeof(T), alignof(T))) T(std::forward<TArgs>(args)...));
+	}
+
+	template<typename T>
+	void RemoveComponent(EntityID entity)
+	{
+		Record(EntityCommandType::REMOVE_COMPONENT, entity, nullEntity, GetComponentTypeID<T>(), nullptr);
+	}
+
+	void Destroy(EntityID entity)
+	{
+		Record(EntityCommandType::DESTROY, entity, nullEntity, 0, nullptr);
+	}
+
+	bool IsEmpty() const
+	{
+		return commands.empty();
+	}
+
+	void Swap(EntityCommandBuffer& other)
+	{
+		std::swap(commands, other.commands);
+		std::swap(spawnTransforms, other.spawnTransforms);
+		std::swap(spawnedEntities, other.spawnedEntities);
+		std::swap(blocks, other.blocks);
+		std::swap(currentBlock, other.currentBlock);
+	}
+
+	void Clear()
+	{
+		for (auto& command : commands)
+		{
+			if (command.payload)
+				componentTypeInfos[command.component].destruct(command.payload);
+		}
+
+		for (auto& block : blocks)
+			block.used = 0;
+
+		commands.clear();
+		spawnTransforms.clear();
+		spawnedEntities.clear();
+		currentBlock = 0;
+	}
+
+	std::vector<EntityCommand> commands;
+	std::vector<Transform> spawnTransforms;
+	std::vector<EntityID> spawnedEntities;
+
+private:
+
+	struct PayloadBlock
+	{
+		unsigned char* data;
+		std::size_t size;
+		std::size_t used;
+	};
+
+	void Record(EntityCommandType type, EntityID entity, std::uint32_t pending, ComponentID component, void* payload)
+	{
+		CommandOrigin& origin = CommandOrigin::GetCurrent();
+
+		commands.push_back({ type, entity, pending, (static_cast<std::uint64_t>(origin.chunk) << 32) | origin.recorded++, component, payload });
+	}
+
+	void* AllocatePayload(std::size_t size, std::size_t alignment)
+	{
+		while (currentBlock < blocks.size())
+		{
+			PayloadBlock& block = blocks[currentBlock];
+			std::size_t offset = (block.used + alignment - 1) & ~(alignment - 1);
+
+			if (offset + size <= block.size)
+			{
+				block.used = offset + size;
+				return block.data + offset;
+			}
+
+			currentBlock++;
+		}
+
+		std::size_t blockSize = std::max<std::size_t>(65536, size);
+
+		blocks.push_back({ static_cast<unsigned char*>(AllocationCounter::Allocate(blockSize, blockAlignment)), blockSize, size });
+
+		return blocks.back().data;
+	}
+
+	static constexpr std::size_t blockAlignment = 64;
+
+	std::vector<PayloadBlock> blocks;
+	std::size_t currentBlock = 0;
+};
+
+// A fully configured entity kept outside the world, holding one copy of each component, for ECSManager::Instantiate to stamp out.
+class Prefab
+{
+
+public:
+
+	template<typename T, typename... TArgs>
+	T& AddComponent(TArgs&&... args)
+	{
+		T component(std::forward<TArgs>(args)...);
+
+		return *static_cast<T*>(AddComponent(GetComponentTypeID<T>(), &component));
+	}
+
+	// Moves the component at source into the prefab, replacing any existing component of the same type.
+	void* AddComponent(ComponentID id, void* source)
+	{
+		if (!componentTypeInfos[id].copyConstruct)
+		{
+			Logger_ThrowError("NULL", "Prefab components must be copy constructible", false);
+			return nullptr;
+		}
+
+		for (auto& column : components)
+		{
+			if (column.id != id)
+				continue;
+
+			componentTypeInfos[id].destruct(column.Get(0));
+			componentTypeInfos[id].moveConstruct(column.Get(0), source);
+
+			return column.Get(0);
+		}
+
+		signature.set(id);
+
+		components.emplace_back(id);
+		components.back().EmplaceFrom(source);
+
+		return components.back().Get(0);
+	}
+
+	template<typename T>
+	T& GetComponent()
+	{
+		for (auto& column : components)
+		{
+			if (column.id == GetComponentTypeID<T>())
+				return *static_cast<T*>(column.Get(0));
+		}
+
+		Logger_ThrowError("NULL", "Prefab has no component of the requested type", true);
+		return *static_cast<T*>(components.front().Get(0));
+	}
+
+	// Copies every component of gameObject, along with its transform, into a new prefab.
+	static Prefab Capture(GameObject& gameObject)
+	{
+		Prefab prefab;
+
+		prefab.transform = gameObject.transform;
+
+		for (ComponentID id = 0; id < componentTypeInfos.size(); ++id)
+		{
+			if (!gameObject.HasComponent(id) || !componentTypeInfos[id].copyConstruct)
+				continue;
+
+			prefab.signature.set(id);
+			prefab.components.emplace_back(id);
+			prefab.components.back().EmplaceCopies(gameObject.GetComponentData(id), 1);
+			componentTypeInfos[id].asComponent(prefab.components.back().Get(0))->gameObject = nullptr;
+		}
+
+		return prefab;
+	}
+
+	Transform transform = TRANSFORM_DEFAULT;
+
+private:
+
+	friend class ECSManager;
+
+	ComponentBitset signature;
+	std::vector<ComponentColumn> components;
+};
+
+class ECSManager
+{
+
+public:
+
+	static GameObject& AddGameObject()
+	{
+		return AddGameObject(ArchetypeManager::GetArchetype(ComponentBitset{}));
+	}
+
+	// Creates count copies of prefab in one structural change: each component array grows once and is filled by copy,
+	// then every copy's components get Start, as AddComponent would. transforms is either empty or holds one per copy.
+	static void Instantiate(const Prefab& prefab, std::size_t count, const std::vector<Transform>& transforms, std::vector<EntityID>& spawned)
+	{
+		if (!transforms.empty() && transforms.size() != count)
+		{
+			Logger_ThrowError("NULL", "Instantiate needs one transform per copy", false);
+			return;
+		}
+
+		Archetype& archetype = ArchetypeManager::GetArchetype(prefab.signature);
+		std::vector<ComponentID> startOrder;
+
+		for (const auto& column : prefab.components)
+		{
+			archetype.GetColumn(column.id).EmplaceCopies(column.Get(0), count);
+			startOrder.push_back(column.id);
+		}
+
+		AddGameObjects(archetype, count, [&](std::size_t c) -> const Transform& { return transforms.empty() ? prefab.transform : transforms[c]; }, startOrder, spawned);
+	}
+
+	// Gives a GameObject to each of the count rows every column of archetype already holds past its last GameObject, placing row c
+	// at getTransform(c), then runs Start on their components in startOrder, as adding them one by one would have.
+	template<typename Function>
+	static void AddGameObjects(Archetype& archetype, std::size_t count, Function&& getTransform, const std::vector<ComponentID>& startOrder, std::vector<EntityID>& spawned)
+	{
+		std::size_t first = archetype.GetCount();
+		std::size_t firstSpawned = spawned.size();
+
+		archetype.entities.reserve(first + count);
+		archetype.gameObjects.reserve(first + count);
+		gameObjects.reserve(gameObjects.size() + count);
+		spawned.reserve(firstSpawned + count);
+
+		for (std::size_t c = 0; c < count; ++c)
+		{
+			GameObject& gameObject = AddGameObject(archetype);
+
+			gameObject.Teleport(getTransform(c));
+
+			for (auto& column : archetype.columns)
+				componentTypeInfos[column.id].asComponent(column.Get(first + c))->gameObject = &gameObject;
+
+			spawned.push_back(gameObject.GetID());
+		}
+
+		// Start may add components or spawn entities, so each copy is looked up again rather than trusting its row.
+		for (std::size_t c = firstSpawned; c < spawned.size(); ++c)
+		{
+			for (ComponentID id : startOrder)
+			{
+				GameObject* gameObject = GetGameObject(spawned[c]);
+
+				if (gameObject && gameObject->HasComponent(id))
+					gameObject->GetComponent(id).Start();
+			}
+		}
+	}
+
+	// Hands out the next free index, or returns false, changing nothing, once every index is either alive or retired.
+	static bool AllocateEntityIndex(std::uint32_t& index)
+	{
+		if (!freeIndices.empty())
+		{
+			index = freeIndices.back();
+			freeIndices.pop_back();
+
+			return true;
+		}
+
+		// An index past entityIndexMask would spill into the generation bits and alias another entity's ID.
+		if (generations.size() > entityIndexMask)
+			return false;
+
+		index = static_cast<std::uint32_t>(generations.size());
+		generations.push_back(0);
+		sparse.push_back(0);
+
+		return true;
+	}
+
+	static GameObject& AddGameObject(Archetype& archetype)
+	{
+		std::uint32_t index;
+
+		// Must not return: a GameObject made from a bad index would alias a live one.
+		if (!AllocateEntityIndex(index))
+			Logger_ThrowFatalErrorNow("NULL", "Out of entity indices: every index is either alive or retired");
+
+		EntityID id = (generations[index] << entityIndexBits) | index;
+
+		sparse[index] = static_cast<std::uint32_t>(gameObjects.size());
+		gameObjects.push_back(gameObjectPool.Create(id, archetype));
+
+		return *gameObjects.back();
+	}
+
+	static bool IsValid(EntityID id)
+	{
+		std::uint32_t index = GetEntityIndex(id);
+
+		return id != nullEntity && index < generations.size() && generations[index] == GetEntityGeneration(id);
+	}
+
+	static GameObject* GetGameObject(EntityID id)
+	{
+		if (!IsValid(id))
+			return nullptr;
+
+		return gameObjects[sparse[GetEntityIndex(id)]];
+	}
+
+	static const std::vector<GameObject*>& GetGameObjects()
+	{
+		return gameObjects;
+	}
+
+	static void DestroyGameObject(EntityID id)
+	{
+		if (!IsValid(id))
+			return;
+
+		std::uint32_t index = GetEntityIndex(id);
+		std::uint32_t slot = sparse[index];
+
+		if (slot != gameObjects.size() - 1)
+		{
+			std::swap(gameObjects[slot], gameObjects.back());
+			sparse[GetEntityIndex(gameObjects[slot]->GetID())] = slot;
+		}
+
+		gameObjectPool.Destroy(gameObjects.back());
+		gameObjects.pop_back();
+
+		generations[index]++;
+
+		// A slot whose generation has run out is retired rather than wrapped, so none of the IDs it handed out can match again.
+		// The last generation is never issued, which also keeps nullEntity from ever being a live ID.
+		if (generations[index] < entityGenerationMask)
+			freeIndices.push_back(index);
+	}
+
+	// Runs one fixed simulation tick; the transform from the previous tick is kept so rendering can interpolate between the two.
+	static void UpdateGameObjects()
+	{
+		for (std::size_t g = gameObjects.size(); g-- > 0;)
+		{
+			if (!gameObjects[g]->active)
+				DestroyGameObject(gameObjects[g]->GetID());
+		}
+
+		for (GameObject* gameObject : gameObjects)
+			gameObject->previousTransform = gameObject->transform;
+
+		UpdateComponents();
+
+		SystemScheduler::Update();
+
+		PlaybackCommandBuffers();
+	}
+
+	// Calls Update once on every component that existed when the tick started. Columns are walked straight through until an Update
+	// adds or removes an entity or component, which can reallocate or reorder the rows being walked; from there on, the entities the
+	// archetype held at the start of the tick are looked up one by one, skipping those destroyed or stripped of the component.
+	static void UpdateComponents()
+	{
+		std::size_t archetypeCount = ArchetypeManager::archetypes.size();
+
+		updateEntities.clear();
+		updateStarts.clear();
+		updateVersions.clear();
+
+		for (std::size_t a = 0; a < archetypeCount; ++a)
+		{
+			Archetype& archetype = *ArchetypeManager::archetypes[a];
+
+			updateStarts.push_back(updateEntities.size());
+			updateVersions.push_back(archetype.version);
+			updateEntities.insert(updateEntities.end(), archetype.entities.begin(), archetype.entities.end());
+		}
+
+		updateStarts.push_back(updateEntities.size());
+
+		for (std::size_t a = 0; a < archetypeCount; ++a)
+		{
+			Archetype& archetype = *ArchetypeManager::archetypes[a];
+
+			for (std::size_t c = 0; c < archetype.columns.size(); ++c)
+			{
+				if (!archetype.columns[c].HasUpdate())
+					continue;
+
+				ComponentID id = archetype.columns[c].id;
+				std::size_t updated = 0;
+
+				if (archetype.version == updateVersions[a])
+					updated = archetype.columns[c].Update(archetype.version);
+
+				for (std::size_t e = updateStarts[a] + updated; e < updateStarts[a + 1]; ++e)
+				{
+					GameObject* gameObject = GetGameObject(updateEntities[e]);
+
+					if (gameObject && gameObject->HasComponent(id))
+						gameObject->UpdateComponent(id);
+				}
+			}
+		}
+	}
+
+	// Each thread records into its own buffer, so systems running on the worker pool can queue structural changes without locking.
+	static EntityCommandBuffer& GetCommandBuffer()
+	{
+		thread_local CommandBufferOwner owner;
+
+		if (!owner.buffer)
+		{
+			std::lock_guard<std::mutex> lock(commandBufferMutex);
+
+			commandBuffers.emplace_back(std::make_unique<EntityCommandBuffer>());
+			owner.buffer = commandBuffers.back().get();
+		}
+
+		return *owner.buffer;
+	}
+
+	static std::size_t GetCommandBufferCount()
+	{
+		std::lock_guard<std::mutex> lock(commandBufferMutex);
+
+		return commandBuffers.size();
+	}
+
+	// Applies every recorded command in one pass: spawns first, then component changes grouped by entity, then destroys.
+	// Within each step commands go by EntityCommand::sequence, so the result does not depend on which thread ran which chunk;
+	// only commands recorded by worker threads outside any system fall back to buffer order.
+	// Commands recorded while playing back (from Start, for example) are applied by a further pass before returning.
+	static void PlaybackCommandBuffers()
+	{
+		while (SwapCommandBuffers())
+		{
+			playbackOrder.clear();
+			spawnOrder.clear();
+
+			for (std::uint32_t b = 0; b < playbackBuffers.size(); ++b)
+			{
+				EntityCommandBuffer& buffer = *playbackBuffers[b];
+
+				buffer.spawnedEntities.resize(buffer.spawnTransforms.size(), nullEntity);
+
+				for (std::uint32_t c = 0; c < buffer.commands.size(); ++c)
+				{
+					if (buffer.commands[c].type == EntityCommandType::SPAWN)
+						spawnOrder.push_back({ b, c });
+					else
+						playbackOrder.push_back({ b, c });
+				}
+			}
+
+			std::sort(spawnOrder.begin(), spawnOrder.end(), IsRecordedBefore);
+
+			gameObjects.reserve(gameObjects.size() + spawnOrder.size());
+
+			for (auto& entry : spawnOrder)
+			{
+				EntityCommandBuffer& buffer = *playbackBuffers[entry.first];
+				std::uint32_t pending = buffer.commands[entry.second].pending;
+				GameObject& gameObject = AddGameObject();
+
+				gameObject.Teleport(buffer.spawnTransforms[pending]);
+				buffer.spawnedEntities[pending] = gameObject.GetID();
+			}
+
+			for (auto& buffer : playbackBuffers)
+			{
+				for (auto& command : buffer->commands)
+				{
+					if (command.entity == nullEntity && command.pending != nullEntity)
+						command.entity = buffer->spawnedEntities[command.pending];
+				}
+			}
+
+			std::sort(playbackOrder.begin(), playbackOrder.end(), [](const std::pair<std::uint32_t, std::uint32_t>& a, const std::pair<std::uint32_t, std::uint32_t>& b)
+			{
+				const EntityCommand& left = playbackBuffers[a.first]->commands[a.second];
+				const EntityCommand& right = playbackBuffers[b.first]->commands[b.second];
+
+				int leftPhase = left.type == EntityCommandType::DESTROY ? 1 : 0;
+				int rightPhase = right.type == EntityCommandType::DESTROY ? 1 : 0;
+
+				if (leftPhase != rightPhase)
+					return leftPhase < rightPhase;
+
+				if (left.entity != right.entity)
+					return left.entity < right.entity;
+
+				return IsRecordedBefore(a, b);
+			});
+
+			for (auto& entry : playbackOrder)
+			{
+				EntityCommand& command = playbackBuffers[entry.first]->commands[entry.second];
+				GameObject* gameObject = GetGameObject(command.entity);
+
+				if (!gameObject)
+					continue;
+
+				switch (command.type)
+				{
+
+				case EntityCommandType::ADD_COMPONENT:
+					gameObject->AddComponent(command.component, command.payload);
+					break;
+
+				case EntityCommandType::REMOVE_COMPONENT:
+					gameObject->RemoveComponent(command.component);
+					break;
+
+				case EntityCommandType::DESTROY:
+					DestroyGameObject(command.entity);
+					break;
+
+				default:
+					break;
+
+				}
+			}
+
+			for (auto& buffer : playbackBuffers)
+				buffer->Clear();
+		}
+
+		// Restarts the main thread's count, so the sequence of next tick's commands does not depend on how long the game has run.
+		CommandOrigin::GetCurrent().recorded = 0;
+	}
+
+	template<typename... Ts>
+	static View<Ts...> Query()
+	{
+		static EntityQuery& query = ArchetypeManager::GetQuery(GetQueryMask<Ts...>());
+
+		return View<Ts...>(query);
+	}
+
+	template<typename... Ts, typename Function>
+	static void ForEach(Function&& function)
+	{
+		Query<Ts...>().Each(function);
+	}
+
+private:
+
+	// Hands a thread's buffer back when the thread exits, so buffers do not pile up as threads come and go.
+	struct CommandBufferOwner
+	{
+		EntityCommandBuffer* buffer = nullptr;
+
+		~CommandBufferOwner()
+		{
+			if (buffer)
+				ReleaseCommandBuffer(buffer);
+		}
+	};
+
+	static void ReleaseCommandBuffer(EntityCommandBuffer* buffer)
+	{
+		std::lock_guard<std::mutex> lock(commandBufferMutex);
+
+		// Commands the thread recorded before exiting still belong to this tick; the buffer is dropped once the next playback has taken them.
+		if (buffer->IsEmpty())
+			commandBuffers.erase(FindCommandBuffer(buffer));
+		else
+			releasedBuffers.push_back(buffer);
+	}
+
+	static std::vector<std::unique_ptr<EntityCommandBuffer>>::iterator FindCommandBuffer(EntityCommandBuffer* buffer)
+	{
+		return std::find_if(commandBuffers.begin(), commandBuffers.end(), [buffer](const std::unique_ptr<EntityCommandBuffer>& owned) { return owned.get() == buffer; });
+	}
+
+	template<typename... Ts>
+	static ComponentBitset GetQueryMask()
+	{
+		ComponentBitset mask;
+		(mask.set(GetComponentTypeID<Ts>()), ...);
+
+		return mask;
+	}
+
+	static bool IsRecordedBefore(const std::pair<std::uint32_t, std::uint32_t>& a, const std::pair<std::uint32_t, std::uint32_t>& b)
+	{
+		std::uint64_t left = playbackBuffers[a.first]->commands[a.second].sequence;
+		std::uint64_t right = playbackBuffers[b.first]->commands[b.second].sequence;
+
+		if (left != right)
+			return left < right;
+
+		return a < b;
+	}
+
+	static bool SwapCommandBuffers()
+	{
+		std::lock_guard<std::mutex> lock(commandBufferMutex);
+
+		bool recorded = false;
+
+		while (playbackBuffers.size() < commandBuffers.size())
+			playbackBuffers.emplace_back(std::make_unique<EntityCommandBuffer>());
+
+		for (std::size_t b = 0; b < commandBuffers.size(); ++b)
+		{
+			recorded |= !commandBuffers[b]->IsEmpty();
+			commandBuffers[b]->Swap(*playbackBuffers[b]);
+		}
+
+		for (EntityCommandBuffer* buffer : releasedBuffers)
+			commandBuffers.erase(FindCommandBuffer(buffer));
+
+		releasedBuffers.clear();
+
+		return recorded;
+	}
+
+	static std::vector<GameObject*> gameObjects;
+	static ObjectPool<GameObject> gameObjectPool;
+	static std::vector<std::uint32_t> sparse;
+	static std::vector<std::uint32_t> generations;
+	static std::vector<std::uint32_t> freeIndices;
+
+	static std::vector<std::unique_ptr<EntityCommandBuffer>> commandBuffers;
+	static std::vector<std::unique_ptr<EntityCommandBuffer>> playbackBuffers;
+	static std::vector<EntityCommandBuffer*> releasedBuffers;
+	static std::vector<std::pair<std::uint32_t, std::uint32_t>> playbackOrder;
+	static std::vector<std::pair<std::uint32_t, std::uint32_t>> spawnOrder;
+	static std::mutex commandBufferMutex;
+
+	static std::vector<EntityID> updateEntities;
+	static std::vector<std::size_t> updateStarts;
+	static std::vector<std::uint32_t> updateVersions;
+
+};
+
+std::vector<GameObject*> ECSManager::gameObjects;
+ObjectPool<GameObject> ECSManager::gameObjectPool;
+std::vector<std::uint32_t> ECSManager::sparse;
+std::vector<std::uint32_t> ECSManager::generations;
+std::vector<std::uint32_t> ECSManager::freeIndices;
+std::vector<std::unique_ptr<EntityCommandBuffer>> ECSManager::commandBuffers;
+std::vector<std::unique_ptr<EntityCommandBuffer>> ECSManager::playbackBuffers;
+std::vector<EntityCommandBuffer*> ECSManager::releasedBuffers;
+std::vector<std::pair<std::uint32_t, std::uint32_t>> ECSManager::playbackOrder;
+std::vector<std::pair<std::uint32_t, std::uint32_t>> ECSManager::spawnOrder;
+std::mutex ECSManager::commandBufferMutex;
+std::vector<EntityID> ECSManager::updateEntities;
+std::vector<std::size_t> ECSManager::updateStarts;
+std::vector<std::uint32_t> ECSManager::updateVersions;
+
+// Defined after the command buffers, so the workers, which release their buffers as they exit, are joined before the buffers are destroyed.
+ThreadPool SystemScheduler::threadPool{ std::max(std::thread::hardware_concurrency(), 1u) - 1 };
 
 #endif // !ECS_HPP
\ No newline at end of file
@@ -17,6 +17,8 @@
 
 #define Logger_WriteConsole(message, level) loggerExecutor.AddTask(std::bind(__LoggerWriteConsole, message, std::string(__FUNCTION__), level))
 #define Logger_ThrowError(unexpectedd, message, fatal) loggerExecutor.AddTask(std::bind(__LoggerThrowError, unexpectedd, message, std::string(__FUNCTION__), __LINE__, fatal))
+// Logger_ThrowError with fatal set exits later, on the logger thread; this one logs and exits on the calling thread and never returns.
+#define Logger_ThrowFatalErrorNow(unexpectedd, message) __LoggerThrowError(unexpectedd, message, std::string(__FUNCTION__), __LINE__, true)
 
 #define Logger_FunctionStart Logger_WriteConsole("Attempting to initalize " + std::string(__FUNCTION__) + "...", LogLevel::DEBUG)
 #define Logger_FunctionEnd Logger_WriteConsole("Successfully initalized " + std::string(__FUNCTION__) + "!", LogLevel::DEBUG)
@@ -0,0 +1,60 @@
+#ifndef TIME_HPP
+#define TIME_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+namespace Time
+{
+	float deltaTime = 0.0f;
+	float fixedDeltaTime = 1.0f / 60.0f;
+	float interpolation = 0.0f;
+
+	int maxTicksPerFrame = 5;
+
+	double lastFrame = 0.0;
+	double accumulator = 0.0;
+	int ticksThisFrame = 0;
+
+	void SetTickRate(float ticksPerSecond)
+	{
+		fixedDeltaTime = 1.0f / ticksPerSecond;
+	}
+
+	void BeginFrame()
+	{
+		double currentFrame = glfwGetTime();
+
+		if (lastFrame == 0.0)
+			lastFrame = currentFrame;
+
+		deltaTime = static_cast<float>(std::min(currentFrame - lastFrame, 0.25));
+		lastFrame = currentFrame;
+
+		accumulator += deltaTime;
+		ticksThisFrame = 0;
+	}
+
+	// Call in a loop after BeginFrame; returns true once per fixed tick owed this frame and then sets interpolation for rendering.
+	bool ShouldTick()
+	{
+		if (accumulator >= fixedDeltaTime && ticksThisFrame < maxTicksPerFrame)
+		{
+			accumulator -= fixedDeltaTime;
+			ticksThisFrame++;
+
+			return true;
+		}
+
+		if (accumulator >= fixedDeltaTime)
+			accumulator = std::fmod(accumulator, static_cast<double>(fixedDeltaTime));
+
+		interpolation = static_cast<float>(accumulator / fixedDeltaTime);
+
+		return false;
+	}
+}
+
+#endif // !TIME_HPP
\ No newline at end of file
@@ -0,0 +1,130 @@
+#ifndef TRANSFORM_HIERARCHY_HPP
+#define TRANSFORM_HIERARCHY_HPP
+
+#include <vector>
+#include <limits>
+#include <glm/glm.hpp>
+#include "components/Transform.hpp"
+#include "core/ECS.hpp"
+
+struct TransformNode
+{
+	GameObject* gameObject;
+	std::int32_t parent;
+
+	Transform local;
+	glm::mat4 world;
+	glm::mat3 normal;
+	bool changed;
+};
+
+class TransformHierarchy
+{
+
+public:
+
+	// Recomputes world matrices for the interpolated transforms; nodes are stored breadth-first so every parent is resolved before its children.
+	static void Update(float interpolation)
+	{
+		if (GameObject::hierarchyChanged)
+			Rebuild();
+
+		for (TransformNode& node : nodes)
+		{
+			Transform local = Transform::Lerp(node.gameObject->previousTransform, node.gameObject->transform, interpolation);
+
+			bool parentChanged = node.parent >= 0 && nodes[node.parent].changed;
+
+			node.changed = parentChanged || !IsSamePlacement(local, node.local);
+
+			if (!node.changed)
+				continue;
+
+			node.local = local;
+			node.world = node.parent >= 0 ? nodes[node.parent].world * local.ToMatrix() : local.ToMatrix();
+			node.normal = glm::transpose(glm::inverse(glm::mat3(node.world)));
+		}
+	}
+
+	static const glm::mat4& GetWorldMatrix(const GameObject& gameObject)
+	{
+		return nodes[gameObject.hierarchyIndex].world;
+	}
+
+	// Inverse transpose of the world matrix's rotation and scale, recomputed only when the world matrix changes.
+	static const glm::mat3& GetNormalMatrix(const GameObject& gameObject)
+	{
+		return nodes[gameObject.hierarchyIndex].normal;
+	}
+
+	static bool HasWorldMatrix(const GameObject& gameObject)
+	{
+		return gameObject.hierarchyIndex >= 0 && static_cast<std::size_t>(gameObject.hierarchyIndex) < nodes.size() && nodes[gameObject.hierarchyIndex].gameObject == &gameObject;
+	}
+
+private:
+
+	static bool IsSamePlacement(const Transform& a, const Transform& b)
+	{
+		return a.position == b.position && a.rotation.x == b.rotation.x && a.rotation.y == b.rotation.y && a.rotation.z == b.rotation.z && a.rotation.w == b.rotation.w;
+	}
+
+	static void Rebuild()
+	{
+		previousNodes.swap(nodes);
+		nodes.clear();
+
+		for (GameObject* gameObject : ECSManager::GetGameObjects())
+		{
+			if (!gameObject->parent)
+				Push(gameObject, -1);
+		}
+
+		for (std::size_t n = 0; n < nodes.size(); ++n)
+		{
+			for (GameObject* child : nodes[n].gameObject->children)
+				Push(child, static_cast<std::int32_t>(n));
+		}
+
+		GameObject::hierarchyChanged = false;
+	}
+
+	static void Push(GameObject* gameObject, std::int32_t parent)
+	{
+		TransformNode node;
+
+		node.gameObject = gameObject;
+		node.parent = parent;
+		node.changed = true;
+
+		std::int32_t previous = gameObject->hierarchyIndex;
+
+		if (previous >= 0 && static_cast<std::size_t>(previous) < previousNodes.size() && previousNodes[previous].gameObject == gameObject)
+		{
+			const TransformNode& old = previousNodes[previous];
+			bool sameParent = parent < 0 ? old.parent < 0 : old.parent >= 0 && previousNodes[old.parent].gameObject == nodes[parent].gameObject;
+
+			if (sameParent)
+			{
+				node.local = old.local;
+				node.world = old.world;
+				node.normal = old.normal;
+				node.changed = false;
+			}
+		}
+
+		if (node.changed)
+			node.local.rotation.w = std::numeric_limits<float>::quiet_NaN();
+
+		gameObject->hierarchyIndex = static_cast<std::int32_t>(nodes.size());
+		nodes.push_back(node);
+	}
+
+	static std::vector<TransformNode> nodes;
+	static std::vector<TransformNode> previousNodes;
+};
+
+std::vector<TransformNode> TransformHierarchy::nodes;
+std::vector<TransformNode> TransformHierarchy::previousNodes;
+
+#endif // !TRANSFORM_HIERARCHY_HPP
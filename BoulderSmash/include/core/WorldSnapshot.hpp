@@ -0,0 +1,265 @@
+#ifndef WORLD_SNAPSHOT_HPP
+#define WORLD_SNAPSHOT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "core/ECS.hpp"
+#include "core/Logger.hpp"
+#include "utils/MappedFile.hpp"
+
+#define worldSnapshotMagic 0x53574253u
+#define worldSnapshotVersion 1u
+
+struct WorldSnapshotHeader
+{
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::uint32_t blockCount;
+};
+
+struct WorldSnapshotBlock
+{
+	std::uint32_t componentCount;
+	std::uint32_t entityCount;
+};
+
+// A block of a snapshot being loaded, checked and pointing into the mapped file; components the world cannot load are already left out.
+struct WorldSnapshotBlockView
+{
+	std::uint32_t entityCount = 0;
+	const unsigned char* transforms = nullptr;
+
+	ComponentBitset signature;
+	std::vector<ComponentID> ids;
+	std::vector<const unsigned char*> arrays;
+};
+
+// A snapshot holds one block per archetype: the component type hashes and snapshot sizes, every entity's Transform, then one tightly packed array per component.
+// Components without a Snapshot struct are left out, so they have to be rebuilt by the Start of a component that is saved.
+namespace WorldSnapshot
+{
+	bool Save(const std::string& path)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+		if (!file)
+		{
+			Logger_ThrowError("NULL", "Unable to open world snapshot '" + path + "' for writing.", false);
+			return false;
+		}
+
+		std::vector<Archetype*> archetypes;
+
+		for (auto& archetype : ArchetypeManager::archetypes)
+		{
+			if (archetype->GetCount() > 0)
+				archetypes.push_back(archetype.get());
+		}
+
+		WorldSnapshotHeader header{ worldSnapshotMagic, worldSnapshotVersion, static_cast<std::uint32_t>(archetypes.size()) };
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		std::vector<unsigned char> buffer;
+
+		for (Archetype* archetype : archetypes)
+		{
+			std::vector<ComponentColumn*> columns;
+			std::vector<ComponentTypeHash> hashes;
+			std::vector<std::uint32_t> sizes;
+
+			for (auto& column : archetype->columns)
+			{
+				const ComponentTypeInfo& info = componentTypeInfos[column.id];
+
+				if (info.snapshotSize == 0)
+					continue;
+
+				columns.push_back(&column);
+				hashes.push_back(info.hash);
+				sizes.push_back(static_cast<std::uint32_t>(info.snapshotSize));
+			}
+
+			std::size_t count = archetype->GetCount();
+
+			WorldSnapshotBlock block{ static_cast<std::uint32_t>(columns.size()), static_cast<std::uint32_t>(count) };
+
+			file.write(reinterpret_cast<const char*>(&block), sizeof(block));
+			file.write(reinterpret_cast<const char*>(hashes.data()), hashes.size() * sizeof(ComponentTypeHash));
+			file.write(reinterpret_cast<const char*>(sizes.data()), sizes.size() * sizeof(std::uint32_t));
+
+			buffer.resize(count * sizeof(Transform));
+
+			for (std::size_t e = 0; e < count; ++e)
+				std::memcpy(buffer.data() + e * sizeof(Transform), &archetype->gameObjects[e]->transform, sizeof(Transform));
+
+			file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+
+			for (std::size_t c = 0; c < columns.size(); ++c)
+			{
+				const ComponentTypeInfo& info = componentTypeInfos[columns[c]->id];
+
+				buffer.resize(count * info.snapshotSize);
+
+				for (std::size_t e = 0; e < count; ++e)
+					info.saveSnapshot(columns[c]->Get(e), buffer.data() + e * info.snapshotSize);
+
+				file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+			}
+		}
+
+		if (!file)
+		{
+			Logger_ThrowError("NULL", "Failed to write world snapshot '" + path + "'.", false);
+			return false;
+		}
+
+		return true;
+	}
+
+	// Adds the entities stored at path to the current world. Every component type in the snapshot must already be registered.
+	// The whole file is checked before anything is added, so a truncated or corrupt snapshot leaves the world untouched.
+	bool Load(const std::string& path)
+	{
+		MappedFile file(path);
+
+		if (!file.data)
+		{
+			Logger_ThrowError("NULL", "Unable to map world snapshot '" + path + "'.", false);
+			return false;
+		}
+
+		const unsigned char* cursor = file.data;
+		const unsigned char* end = file.data + file.size;
+
+		auto take = [&](std::size_t bytes) -> const unsigned char*
+		{
+			if (static_cast<std::size_t>(end - cursor) < bytes)
+				return nullptr;
+
+			const unsigned char* taken = cursor;
+			cursor += bytes;
+
+			return taken;
+		};
+
+		WorldSnapshotHeader header;
+		const unsigned char* headerData = take(sizeof(header));
+
+		if (!headerData)
+		{
+			Logger_ThrowError("NULL", "World snapshot '" + path + "' is truncated.", false);
+			return false;
+		}
+
+		std::memcpy(&header, headerData, sizeof(header));
+
+		if (header.magic != worldSnapshotMagic || header.version != worldSnapshotVersion)
+		{
+			Logger_ThrowError("NULL", "'" + path + "' is not a supported world snapshot.", false);
+			return false;
+		}
+
+		std::vector<WorldSnapshotBlockView> blocks;
+
+		for (std::uint32_t b = 0; b < header.blockCount; ++b)
+		{
+			WorldSnapshotBlock block;
+			const unsigned char* blockData = take(sizeof(block));
+
+			if (!blockData)
+			{
+				Logger_ThrowError("NULL", "World snapshot '" + path + "' is truncated.", false);
+				return false;
+			}
+
+			std::memcpy(&block, blockData, sizeof(block));
+
+			const unsigned char* hashData = take(static_cast<std::size_t>(block.componentCount) * sizeof(ComponentTypeHash));
+			const unsigned char* sizeData = take(static_cast<std::size_t>(block.componentCount) * sizeof(std::uint32_t));
+			const unsigned char* transforms = take(static_cast<std::size_t>(block.entityCount) * sizeof(Transform));
+
+			if (!hashData || !sizeData || !transforms)
+			{
+				Logger_ThrowError("NULL", "World snapshot '" + path + "' is truncated.", false);
+				return false;
+			}
+
+			WorldSnapshotBlockView view;
+
+			view.entityCount = block.entityCount;
+			view.transforms = transforms;
+
+			std::vector<ComponentTypeHash> hashes(block.componentCount);
+
+			std::memcpy(hashes.data(), hashData, hashes.size() * sizeof(ComponentTypeHash));
+
+			for (std::uint32_t c = 0; c < block.componentCount; ++c)
+			{
+				std::uint32_t size;
+				std::memcpy(&size, sizeData + c * sizeof(std::uint32_t), sizeof(size));
+
+				const unsigned char* array = take(static_cast<std::size_t>(block.entityCount) * size);
+
+				if (!array)
+				{
+					Logger_ThrowError("NULL", "World snapshot '" + path + "' is truncated.", false);
+					return false;
+				}
+
+				if (std::count(hashes.begin(), hashes.begin() + c, hashes[c]) != 0)
+				{
+					Logger_ThrowError("NULL", "World snapshot '" + path + "' stores a component type twice in one block.", false);
+					return false;
+				}
+
+				ComponentID id = GetComponentTypeIDFromHash(hashes[c]);
+
+				if (id == static_cast<ComponentID>(-1) || componentTypeInfos[id].snapshotSize != size)
+				{
+					Logger_WriteConsole("Skipping an unregistered or changed component type in world snapshot '" + path + "'", LogLevel::WARNING);
+					continue;
+				}
+
+				view.signature.set(id);
+				view.ids.push_back(id);
+				view.arrays.push_back(array);
+			}
+
+			blocks.push_back(std::move(view));
+		}
+
+		if (cursor != end)
+		{
+			Logger_ThrowError("NULL", "World snapshot '" + path + "' has data past its last block.", false);
+			return false;
+		}
+
+		// Each block fills its archetype's columns straight from the packed arrays, then its entities join the filled rows at once.
+		std::vector<EntityID> spawned;
+
+		for (const WorldSnapshotBlockView& block : blocks)
+		{
+			Archetype& archetype = ArchetypeManager::GetArchetype(block.signature);
+
+			for (std::size_t c = 0; c < block.ids.size(); ++c)
+				archetype.GetColumn(block.ids[c]).EmplaceSnapshots(block.arrays[c], block.entityCount);
+
+			ECSManager::AddGameObjects(archetype, block.entityCount, [&](std::size_t e)
+			{
+				Transform transform;
+
+				std::memcpy(&transform, block.transforms + e * sizeof(Transform), sizeof(Transform));
+
+				return transform;
+			}, block.ids, spawned);
+		}
+
+		return true;
+	}
+}
+
+#endif // !WORLD_SNAPSHOT_HPP
@@ -2,29 +2,48 @@
 #define ASTEROID_MANAGER_HPP
 
 #include <vector>
+#include "components/RigidBody.hpp"
 #include "gameplay/EntityAsteroid.hpp"
 
 namespace AsteroidManager
 {
-	extern std::vector<EntityAsteroid> spawnedAsteroids;
+	extern std::vector<EntityID> spawnedAsteroids;
 
-	void SpawnAsteroid(const Transform& transform, const BoxCollider& collider, const std::string& name)
+	EntityID SpawnAsteroid(const Transform& transform, const BoxCollider& collider, const RigidBody& body, const std::string& name)
 	{
 		GameObject& gameObject = ECSManager::AddGameObject();
 
-		EntityAsteroid& asteroid = gameObject.AddComponent<EntityAsteroid>();
-		asteroid.Start();
-		asteroid.gameObject->transform = transform;
-		asteroid.name = name;
+		gameObject.Teleport(transform);
 
-		BoxCollider& boxCollider = gameObject.AddComponent<BoxCollider>();
-		boxCollider = collider;
+		gameObject.AddComponent<EntityAsteroid>().name = name;
+		gameObject.AddComponent<BoxCollider>(collider);
+		gameObject.AddComponent<RigidBody>(body);
 
-		spawnedAsteroids.push_back(gameObject.GetComponent<EntityAsteroid>());
-		EntityManager::RegisterEntity(gameObject.GetComponent<EntityAsteroid>());
+		spawnedAsteroids.push_back(gameObject.GetID());
+
+		return gameObject.GetID();
+	}
+
+	// Configures one asteroid up front, Model included, so waves can be stamped out with SpawnAsteroids.
+	Prefab CreateAsteroidPrefab(const BoxCollider& collider, const RigidBody& body, const std::string& name)
+	{
+		Prefab prefab;
+
+		prefab.AddComponent<EntityAsteroid>().name = name;
+		prefab.AddComponent<BoxCollider>(collider);
+		prefab.AddComponent<RigidBody>(body);
+		prefab.AddComponent<Model>().GenerateModel(asteroidModelPath, name, glm::vec3{ 0.0f, 0.0f, 0.0f });
+
+		return prefab;
+	}
+
+	// Spawns one asteroid per transform in a single batch.
+	void SpawnAsteroids(const Prefab& prefab, const std::vector<Transform>& transforms)
+	{
+		ECSManager::Instantiate(prefab, transforms.size(), transforms, spawnedAsteroids);
 	}
 }
 
-std::vector<EntityAsteroid> AsteroidManager::spawnedAsteroids;
+std::vector<EntityID> AsteroidManager::spawnedAsteroids;
 
 #endif // !ASTEROID_MANAGER_HPP
\ No newline at end of file
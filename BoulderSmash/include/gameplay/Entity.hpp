@@ -2,6 +2,8 @@
 #define ENTITY_HPP
 
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <memory>
 #include <format>
 #include "components/BoxCollider.hpp"
@@ -30,9 +32,28 @@ public:
 			gameObject->GetComponent<Model>().data.transform.position = transform.position;
 			gameObject->GetComponent<Model>().data.transform.rotation = transform.rotation;
 		}*/
-		
-		if(gameObject->HasComponent<BoxCollider>())
-			gameObject->GetComponent<BoxCollider>().gameObject->transform = gameObject->transform;
+	}
+
+	struct Snapshot
+	{
+		float maxHealth;
+		float currentHealth;
+		char name[64];
+	};
+
+	Snapshot SaveSnapshot() const
+	{
+		Snapshot snapshot{ maxHealth, currentHealth, {} };
+		name.copy(snapshot.name, sizeof(snapshot.name) - 1);
+
+		return snapshot;
+	}
+
+	void LoadSnapshot(const Snapshot& snapshot)
+	{
+		maxHealth = snapshot.maxHealth;
+		currentHealth = snapshot.currentHealth;
+		name = snapshot.name;
 	}
 
 	float maxHealth = 20.0f;
@@ -48,25 +69,39 @@ private:
 
 namespace EntityManager
 {
-	extern std::vector<Entity> registeredEntities;
+	extern std::vector<EntityID> registeredEntities;
+	extern std::size_t compactionSize;
+
+	// Destroyed entities leave their IDs behind; the generation check finds them, as their slots may already hold someone else.
+	void RemoveStaleEntities()
+	{
+		std::erase_if(registeredEntities, [](EntityID id) { return !ECSManager::IsValid(id); });
+
+		compactionSize = std::max<std::size_t>(64, registeredEntities.size() * 2);
+	}
 	
-	void RegisterEntity(Entity& entity)
+	// Compacts once the list has doubled since the last compaction, so spawning and destroying forever keeps it bounded.
+	void RegisterEntity(const Entity& entity)
 	{
-		registeredEntities.push_back(entity);
+		if (registeredEntities.size() >= compactionSize)
+			RemoveStaleEntities();
+
+		registeredEntities.push_back(entity.gameObject->GetID());
 	}
 	 
-	Entity& GetEntity(const std::string& name)
+	template<typename T>
+	T* GetEntity(EntityID id)
 	{
-		for (Entity& entity : registeredEntities)
-		{
-			if (entity.name == name)
-				return entity;
-		}
+		GameObject* gameObject = ECSManager::GetGameObject(id);
+
+		if (!gameObject || !gameObject->HasComponent<T>())
+			return nullptr;
 
-		Logger_ThrowError("NULL", std::format("Entity: '{}' was not found.", name), false);
+		return &gameObject->GetComponent<T>();
 	}
 }
 
-std::vector<Entity> EntityManager::registeredEntities;
+std::vector<EntityID> EntityManager::registeredEntities;
+std::size_t EntityManager::compactionSize = 64;
 
 #endif // !ENTITY_HPP
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "gameplay/Entity.hpp"
 #include "rendering/Model.hpp"
 
+#define asteroidModelPath "assets/characters/asteroid/model/model.obj"
+
 struct EntityAsteroid : public Entity
 {
 	
@@ -11,16 +13,11 @@ public:
 
 	void Start() override
 	{
-		gameObject->AddComponent<Model>();
-		gameObject->GetComponent<Model>().GenerateModel("assets/characters/asteroid/model/model.obj", "asteroid", glm::vec3{ 0.0f, 0.0f, 0.0f });
-	}
-
-	void Update() override
-	{
-		gameObject->transform.Rotate(glm::quat{5, 0, 0, 1});
+		EntityManager::RegisterEntity(*this);
 
-		gameObject->GetComponent<Model>().data.transform.position = gameObject->transform.position;
-		gameObject->GetComponent<Model>().data.transform.rotation = gameObject->transform.rotation;
+		// Asteroids instantiated from a prefab already carry their Model.
+		if (!gameObject->HasComponent<Model>())
+			gameObject->AddComponent<Model>().GenerateModel(asteroidModelPath, "asteroid", glm::vec3{ 0.0f, 0.0f, 0.0f });
 	}
 
 private:
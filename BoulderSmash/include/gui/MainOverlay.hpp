@@ -4,6 +4,7 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include "gui/TextManager.hpp"
+#include "rendering/GLState.hpp"
 
 struct MainOverlay
 {
@@ -27,7 +28,9 @@ struct MainOverlay
 		{
 			double fps = double(frameCount) / deltaTime;
 
-			text = "FPS: " + std::to_string((int)round(fps));
+			const GLStateCounters& counters = GLState::GetLastFrameCounters();
+
+			text = "FPS: " + std::to_string((int)round(fps)) + "  GL calls: " + std::to_string(counters.issued) + " issued, " + std::to_string(counters.filtered) + " filtered";
 
 			frameCount = 0;
 			lastTime = currentTime;
@@ -12,6 +12,7 @@
 #include <glm/vec2.hpp>
 #include "core/Logger.hpp"
 #include "core/Window.hpp"
+#include "rendering/GLState.hpp"
 #include "rendering/ShaderManager.hpp"
 
 struct Character 
@@ -27,6 +28,8 @@ namespace TextManager
 {
     extern unsigned int VAO, VBO;
     extern ShaderObject shader;
+    extern UniformHandle projectionUniform;
+    extern UniformHandle textColorUniform;
     extern std::map<GLchar, Character> characters;
 	extern std::string fontPath;
 
@@ -35,16 +38,19 @@ namespace TextManager
         shader = ShaderManager::GetShader("textShader");
         shader.BindShader();
 
+        projectionUniform = shader.GetUniform("projection");
+        textColorUniform = shader.GetUniform("textColor");
+
         glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(Window::size.x), 0.0f, static_cast<float>(Window::size.y));
 
         shader.Use();
-        glUniformMatrix4fv(glGetUniformLocation(shader.ID, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+        shader.SetMat4(projectionUniform, projection);
     }
 
     void UpdateRendering()
     {
         shader.Use();
-        glUniformMatrix4fv(glGetUniformLocation(shader.ID, "projection"), 1, GL_FALSE, glm::value_ptr(glm::ortho(0.0f, static_cast<float>(Window::size.x), 0.0f, static_cast<float>(Window::size.y))));
+        shader.SetMat4(projectionUniform, glm::ortho(0.0f, static_cast<float>(Window::size.x), 0.0f, static_cast<float>(Window::size.y)));
     }
 
 	void InitText()
@@ -119,9 +125,10 @@ namespace TextManager
     void RenderText(const std::string& text, glm::vec2 position, const glm::vec2& scale, const glm::vec3& color)
     {
         shader.Use();
-        glUniform3f(glGetUniformLocation(shader.ID, "textColor"), color.x, color.y, color.z);
-        glActiveTexture(GL_TEXTURE0);
-        glBindVertexArray(VAO);
+        shader.SetVec3(textColorUniform, color.x, color.y, color.z);
+
+        GLState::BindVertexArray(VAO);
+        GLState::BindBuffer(GL_ARRAY_BUFFER, VBO);
 
         glm::vec2 screenPosition = glm::vec2{ position.x * Window::size.x, position.y * Window::size.y };
         std::string::const_iterator c;
@@ -147,26 +154,22 @@ namespace TextManager
                 { xpos + w, ypos + h,   1.0f, 0.0f }
             };
             
-            glBindTexture(GL_TEXTURE_2D, ch.textureID);
+            GLState::BindTexture(0, GL_TEXTURE_2D, ch.textureID);
             
-            glBindBuffer(GL_ARRAY_BUFFER, VBO);
             glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
             
             glDrawArrays(GL_TRIANGLES, 0, 6);
             
             screenPosition.x += (ch.advance >> 6) * scale.x;
         }
-
-        glBindVertexArray(0);
-        glBindTexture(GL_TEXTURE_2D, 0);
     }
 }
 
 unsigned int TextManager::VAO;
 unsigned int TextManager::VBO;
 ShaderObject TextManager::shader;
+UniformHandle TextManager::projectionUniform;
+UniformHandle TextManager::textColorUniform;
 std::map<GLchar, Character> TextManager::characters;
 std::string TextManager::fontPath;
 
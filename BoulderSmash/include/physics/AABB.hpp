@@ -0,0 +1,120 @@
+#ifndef AABB_HPP
+#define AABB_HPP
+
+#include <cmath>
+#include <utility>
+#include <glm/glm.hpp>
+
+struct AABB
+{
+	bool Overlaps(const AABB& other) const
+	{
+		return (min.x < other.max.x && max.x > other.min.x) &&
+			(min.y < other.max.y && max.y > other.min.y) &&
+			(min.z < other.max.z && max.z > other.min.z);
+	}
+
+	bool Contains(const AABB& other) const
+	{
+		return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+			max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+	}
+
+	float GetSurfaceArea() const
+	{
+		glm::vec3 extent = max - min;
+
+		return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+	}
+
+	// Slab test; distance is set to where the ray enters the box, or 0 when it starts inside.
+	// A zero direction component makes its inverse infinite and 0 * inf a NaN, so a ray parallel to a slab is settled by where it starts instead.
+	bool IntersectsRay(const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance, float& distance) const
+	{
+		float enter = 0.0f;
+		float leave = maxDistance;
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			if (std::isinf(inverseDirection[axis]))
+			{
+				if (origin[axis] < min[axis] || origin[axis] > max[axis])
+					return false;
+
+				continue;
+			}
+
+			float toMin = (min[axis] - origin[axis]) * inverseDirection[axis];
+			float toMax = (max[axis] - origin[axis]) * inverseDirection[axis];
+
+			enter = glm::max(enter, glm::min(toMin, toMax));
+			leave = glm::min(leave, glm::max(toMin, toMax));
+		}
+
+		distance = enter;
+
+		return enter <= leave;
+	}
+
+	// Moves a by da and b by db over one step and finds the first moment they overlap, as a fraction of the step in [0, 1].
+	static bool Sweep(const AABB& a, const glm::vec3& da, const AABB& b, const glm::vec3& db, float& timeOfImpact)
+	{
+		if (a.Overlaps(b))
+		{
+			timeOfImpact = 0.0f;
+			return true;
+		}
+
+		glm::vec3 velocity = da - db;
+
+		float enter = 0.0f;
+		float exit = 1.0f;
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			if (velocity[axis] == 0.0f)
+			{
+				if (a.max[axis] <= b.min[axis] || a.min[axis] >= b.max[axis])
+					return false;
+
+				continue;
+			}
+
+			float axisEnter = (b.min[axis] - a.max[axis]) / velocity[axis];
+			float axisExit = (b.max[axis] - a.min[axis]) / velocity[axis];
+
+			if (axisEnter > axisExit)
+				std::swap(axisEnter, axisExit);
+
+			enter = glm::max(enter, axisEnter);
+			exit = glm::min(exit, axisExit);
+
+			if (enter >= exit)
+				return false;
+		}
+
+		timeOfImpact = enter;
+
+		return true;
+	}
+
+	static AABB Union(const AABB& a, const AABB& b)
+	{
+		return Register(glm::min(a.min, b.min), glm::max(a.max, b.max));
+	}
+
+	static AABB Register(const glm::vec3& min, const glm::vec3& max)
+	{
+		AABB out;
+
+		out.min = min;
+		out.max = max;
+
+		return out;
+	}
+
+	glm::vec3 min;
+	glm::vec3 max;
+};
+
+#endif // !AABB_HPP
@@ -0,0 +1,173 @@
+#ifndef AABB_BATCH_HPP
+#define AABB_BATCH_HPP
+
+#include <vector>
+#include <cstdint>
+#include "physics/AABB.hpp"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define aabbBatchSimd
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define avx2Target
+#else
+#define avx2Target __attribute__((target("avx2")))
+#endif
+#endif
+
+// Boxes stored as separate min/max arrays so one box can be tested against many with wide compares.
+struct AABBBatch
+{
+	void Add(const AABB& bounds)
+	{
+		minX.push_back(bounds.min.x);
+		minY.push_back(bounds.min.y);
+		minZ.push_back(bounds.min.z);
+		maxX.push_back(bounds.max.x);
+		maxY.push_back(bounds.max.y);
+		maxZ.push_back(bounds.max.z);
+	}
+
+	void Clear()
+	{
+		minX.clear();
+		minY.clear();
+		minZ.clear();
+		maxX.clear();
+		maxY.clear();
+		maxZ.clear();
+	}
+
+	std::size_t Size() const
+	{
+		return minX.size();
+	}
+
+	std::vector<float> minX, minY, minZ;
+	std::vector<float> maxX, maxY, maxZ;
+};
+
+enum class AABBOverlapPath
+{
+	SCALAR,
+	SSE,
+	AVX2
+};
+
+namespace AABBOverlap
+{
+	using OverlapFunction = void (*)(const AABB& box, const AABBBatch& batch, std::size_t begin, std::uint64_t* mask);
+
+	// Sets bit i of mask (one 64-bit word per 64 boxes) when box overlaps batch box i, using the same strict test as AABB::Overlaps.
+	void TestScalar(const AABB& box, const AABBBatch& batch, std::size_t begin, std::uint64_t* mask)
+	{
+		for (std::size_t i = begin; i < batch.Size(); ++i)
+		{
+			bool hit = box.min.x < batch.maxX[i] && box.max.x > batch.minX[i] &&
+				box.min.y < batch.maxY[i] && box.max.y > batch.minY[i] &&
+				box.min.z < batch.maxZ[i] && box.max.z > batch.minZ[i];
+
+			mask[i >> 6] |= static_cast<std::uint64_t>(hit) << (i & 63);
+		}
+	}
+
+#ifdef aabbBatchSimd
+	void TestSSE(const AABB& box, const AABBBatch& batch, std::size_t begin, std::uint64_t* mask)
+	{
+		__m128 boxMinX = _mm_set1_ps(box.min.x), boxMinY = _mm_set1_ps(box.min.y), boxMinZ = _mm_set1_ps(box.min.z);
+		__m128 boxMaxX = _mm_set1_ps(box.max.x), boxMaxY = _mm_set1_ps(box.max.y), boxMaxZ = _mm_set1_ps(box.max.z);
+
+		std::size_t count = batch.Size();
+		std::size_t i = begin;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 hit = _mm_and_ps(_mm_cmplt_ps(boxMinX, _mm_loadu_ps(&batch.maxX[i])), _mm_cmpgt_ps(boxMaxX, _mm_loadu_ps(&batch.minX[i])));
+			hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmplt_ps(boxMinY, _mm_loadu_ps(&batch.maxY[i])), _mm_cmpgt_ps(boxMaxY, _mm_loadu_ps(&batch.minY[i]))));
+			hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmplt_ps(boxMinZ, _mm_loadu_ps(&batch.maxZ[i])), _mm_cmpgt_ps(boxMaxZ, _mm_loadu_ps(&batch.minZ[i]))));
+
+			mask[i >> 6] |= static_cast<std::uint64_t>(_mm_movemask_ps(hit)) << (i & 63);
+		}
+
+		TestScalar(box, batch, i, mask);
+	}
+
+	avx2Target void TestAVX2(const AABB& box, const AABBBatch& batch, std::size_t begin, std::uint64_t* mask)
+	{
+		__m256 boxMinX = _mm256_set1_ps(box.min.x), boxMinY = _mm256_set1_ps(box.min.y), boxMinZ = _mm256_set1_ps(box.min.z);
+		__m256 boxMaxX = _mm256_set1_ps(box.max.x), boxMaxY = _mm256_set1_ps(box.max.y), boxMaxZ = _mm256_set1_ps(box.max.z);
+
+		std::size_t count = batch.Size();
+		std::size_t i = begin;
+
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 hit = _mm256_and_ps(_mm256_cmp_ps(boxMinX, _mm256_loadu_ps(&batch.maxX[i]), _CMP_LT_OQ), _mm256_cmp_ps(boxMaxX, _mm256_loadu_ps(&batch.minX[i]), _CMP_GT_OQ));
+			hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(boxMinY, _mm256_loadu_ps(&batch.maxY[i]), _CMP_LT_OQ), _mm256_cmp_ps(boxMaxY, _mm256_loadu_ps(&batch.minY[i]), _CMP_GT_OQ)));
+			hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(boxMinZ, _mm256_loadu_ps(&batch.maxZ[i]), _CMP_LT_OQ), _mm256_cmp_ps(boxMaxZ, _mm256_loadu_ps(&batch.minZ[i]), _CMP_GT_OQ)));
+
+			mask[i >> 6] |= static_cast<std::uint64_t>(_mm256_movemask_ps(hit)) << (i & 63);
+		}
+
+		TestScalar(box, batch, i, mask);
+	}
+
+	bool SupportsAVX2()
+	{
+#ifdef _MSC_VER
+		int info[4];
+
+		__cpuid(info, 1);
+
+		bool osSavesYmm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 0x6) == 0x6;
+
+		__cpuidex(info, 7, 0);
+
+		return osSavesYmm && (info[1] & (1 << 5));
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+#endif
+
+	AABBOverlapPath SelectPath()
+	{
+#ifdef aabbBatchSimd
+		if (SupportsAVX2())
+			return AABBOverlapPath::AVX2;
+
+		return AABBOverlapPath::SSE;
+#else
+		return AABBOverlapPath::SCALAR;
+#endif
+	}
+
+	OverlapFunction GetFunction(AABBOverlapPath path)
+	{
+#ifdef aabbBatchSimd
+		if (path == AABBOverlapPath::AVX2)
+			return TestAVX2;
+
+		if (path == AABBOverlapPath::SSE)
+			return TestSSE;
+#endif
+		return TestScalar;
+	}
+
+	extern AABBOverlapPath path;
+
+	// Tests box against every box in batch on the widest path the CPU supports; mask is resized and cleared first.
+	void Test(const AABB& box, const AABBBatch& batch, std::vector<std::uint64_t>& mask)
+	{
+		mask.assign((batch.Size() + 63) / 64, 0);
+
+		if (batch.Size() > 0)
+			GetFunction(path)(box, batch, 0, mask.data());
+	}
+}
+
+AABBOverlapPath AABBOverlap::path = AABBOverlap::SelectPath();
+
+#endif // !AABB_BATCH_HPP
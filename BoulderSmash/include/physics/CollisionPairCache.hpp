@@ -0,0 +1,94 @@
+#ifndef COLLISION_PAIR_CACHE_HPP
+#define COLLISION_PAIR_CACHE_HPP
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "core/ECS.hpp"
+
+enum class CollisionEventType
+{
+	ENTER,
+	STAY,
+	EXIT
+};
+
+struct CollisionEvent
+{
+	bool Involves(EntityID entity) const
+	{
+		return a == entity || b == entity;
+	}
+
+	EntityID GetOther(EntityID entity) const
+	{
+		return a == entity ? b : a;
+	}
+
+	CollisionEventType type;
+	EntityID a;
+	EntityID b;
+};
+
+// Remembers which collider pairs touched last tick so a tick's pairs can be turned into enter, stay and exit events.
+class CollisionPairCache
+{
+
+public:
+
+	static std::uint64_t GetPairKey(EntityID a, EntityID b)
+	{
+		if (a > b)
+			std::swap(a, b);
+
+		return (static_cast<std::uint64_t>(a) << 32) | b;
+	}
+
+	void AddPair(EntityID a, EntityID b)
+	{
+		currentPairs.push_back(GetPairKey(a, b));
+	}
+
+	// Merges this tick's sorted pairs against last tick's, appending one event per pair to events.
+	void Update(std::vector<CollisionEvent>& events)
+	{
+		std::sort(currentPairs.begin(), currentPairs.end());
+		currentPairs.erase(std::unique(currentPairs.begin(), currentPairs.end()), currentPairs.end());
+
+		std::size_t current = 0;
+		std::size_t previous = 0;
+
+		while (current < currentPairs.size() || previous < previousPairs.size())
+		{
+			if (previous == previousPairs.size() || (current < currentPairs.size() && currentPairs[current] < previousPairs[previous]))
+				Emit(events, CollisionEventType::ENTER, currentPairs[current++]);
+			else if (current == currentPairs.size() || previousPairs[previous] < currentPairs[current])
+				Emit(events, CollisionEventType::EXIT, previousPairs[previous++]);
+			else
+			{
+				Emit(events, CollisionEventType::STAY, currentPairs[current++]);
+				previous++;
+			}
+		}
+
+		previousPairs.swap(currentPairs);
+		currentPairs.clear();
+	}
+
+	std::size_t GetContactCount() const
+	{
+		return previousPairs.size();
+	}
+
+private:
+
+	static void Emit(std::vector<CollisionEvent>& events, CollisionEventType type, std::uint64_t key)
+	{
+		events.push_back({ type, static_cast<EntityID>(key >> 32), static_cast<EntityID>(key) });
+	}
+
+	std::vector<std::uint64_t> currentPairs;
+	std::vector<std::uint64_t> previousPairs;
+};
+
+#endif // !COLLISION_PAIR_CACHE_HPP
@@ -0,0 +1,415 @@
+#ifndef DYNAMIC_AABB_TREE_HPP
+#define DYNAMIC_AABB_TREE_HPP
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "core/ECS.hpp"
+#include "physics/AABB.hpp"
+
+#define nullNode -1
+
+struct AABBTreeNode
+{
+	bool IsLeaf() const
+	{
+		return child1 == nullNode;
+	}
+
+	AABB bounds;
+
+	std::int32_t parent;
+	std::int32_t child1;
+	std::int32_t child2;
+	std::int32_t height;
+
+	EntityID entity;
+	std::uint32_t index;
+};
+
+class DynamicAABBTree
+{
+
+public:
+
+	// Leaves hold bounds enlarged by margin, so a collider only has to be reinserted once it leaves its fat box.
+	std::int32_t CreateProxy(const AABB& bounds, EntityID entity, std::uint32_t index)
+	{
+		std::int32_t proxy = AllocateNode();
+
+		nodes[proxy].bounds = AABB::Register(bounds.min - glm::vec3{ margin }, bounds.max + glm::vec3{ margin });
+		nodes[proxy].entity = entity;
+		nodes[proxy].index = index;
+		nodes[proxy].height = 0;
+
+		InsertLeaf(proxy);
+
+		return proxy;
+	}
+
+	void DestroyProxy(std::int32_t proxy)
+	{
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+	}
+
+	// Returns true when the proxy had to be reinserted; the fat box is stretched along displacement to anticipate the next move.
+	bool MoveProxy(std::int32_t proxy, const AABB& bounds, const glm::vec3& displacement)
+	{
+		if (nodes[proxy].bounds.Contains(bounds))
+			return false;
+
+		RemoveLeaf(proxy);
+
+		AABB fat = AABB::Register(bounds.min - glm::vec3{ margin }, bounds.max + glm::vec3{ margin });
+		glm::vec3 predicted = displacement * displacementMultiplier;
+
+		fat.min += glm::min(predicted, glm::vec3{ 0.0f });
+		fat.max += glm::max(predicted, glm::vec3{ 0.0f });
+
+		nodes[proxy].bounds = fat;
+
+		InsertLeaf(proxy);
+
+		return true;
+	}
+
+	const AABB& GetFatBounds(std::int32_t proxy) const
+	{
+		return nodes[proxy].bounds;
+	}
+
+	EntityID GetEntity(std::int32_t proxy) const
+	{
+		return nodes[proxy].entity;
+	}
+
+	std::uint32_t GetIndex(std::int32_t proxy) const
+	{
+		return nodes[proxy].index;
+	}
+
+	void SetIndex(std::int32_t proxy, std::uint32_t index)
+	{
+		nodes[proxy].index = index;
+	}
+
+	std::int32_t GetHeight() const
+	{
+		return root == nullNode ? 0 : nodes[root].height;
+	}
+
+	std::int32_t GetRoot() const
+	{
+		return root;
+	}
+
+	const AABBTreeNode& GetNode(std::int32_t node) const
+	{
+		return nodes[node];
+	}
+
+	// Calls callback(proxy) for every leaf whose fat box overlaps bounds; returning false from the callback stops the query.
+	// Queries may run on several threads at once, but a callback must not start another query on the same thread.
+	template<typename Function>
+	void Query(const AABB& bounds, Function&& callback) const
+	{
+		std::vector<std::int32_t>& stack = GetStack();
+
+		stack.clear();
+		stack.push_back(root);
+
+		while (!stack.empty())
+		{
+			std::int32_t node = stack.back();
+			stack.pop_back();
+
+			if (node == nullNode || !nodes[node].bounds.Overlaps(bounds))
+				continue;
+
+			if (nodes[node].IsLeaf())
+			{
+				if (!callback(node))
+					return;
+			}
+			else
+			{
+				stack.push_back(nodes[node].child1);
+				stack.push_back(nodes[node].child2);
+			}
+		}
+	}
+
+	// Calls callback(proxy, maxDistance) for every leaf the ray reaches; the callback returns the new maximum distance, so returning the hit distance clips the ray and 0 ends the cast.
+	// A non-zero extent grows every node by that half size, turning the ray into a swept box.
+	template<typename Function>
+	void RayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Function&& callback, const glm::vec3& extent = glm::vec3{ 0.0f }) const
+	{
+		glm::vec3 inverseDirection = 1.0f / direction;
+
+		std::vector<std::int32_t>& stack = GetStack();
+
+		stack.clear();
+		stack.push_back(root);
+
+		while (!stack.empty())
+		{
+			std::int32_t node = stack.back();
+			stack.pop_back();
+
+			if (node == nullNode)
+				continue;
+
+			float distance;
+			AABB grown = AABB::Register(nodes[node].bounds.min - extent, nodes[node].bounds.max + extent);
+
+			if (!grown.IntersectsRay(origin, inverseDirection, maxDistance, distance))
+				continue;
+
+			if (nodes[node].IsLeaf())
+			{
+				maxDistance = callback(node, maxDistance);
+
+				if (maxDistance <= 0.0f)
+					return;
+			}
+			else
+			{
+				stack.push_back(nodes[node].child1);
+				stack.push_back(nodes[node].child2);
+			}
+		}
+	}
+
+	template<typename Function>
+	void ForEachProxy(Function&& callback) const
+	{
+		for (std::int32_t n = 0; n < static_cast<std::int32_t>(nodes.size()); ++n)
+		{
+			if (nodes[n].height == 0)
+				callback(n);
+		}
+	}
+
+	float margin = 0.5f;
+	float displacementMultiplier = 2.0f;
+
+private:
+
+	static std::vector<std::int32_t>& GetStack()
+	{
+		thread_local std::vector<std::int32_t> stack;
+		return stack;
+	}
+
+	std::int32_t AllocateNode()
+	{
+		if (freeList == nullNode)
+		{
+			nodes.emplace_back();
+			nodes.back().parent = nullNode;
+			nodes.back().height = -1;
+
+			freeList = static_cast<std::int32_t>(nodes.size()) - 1;
+		}
+
+		std::int32_t node = freeList;
+
+		freeList = nodes[node].parent;
+
+		nodes[node].parent = nullNode;
+		nodes[node].child1 = nullNode;
+		nodes[node].child2 = nullNode;
+		nodes[node].height = 0;
+		nodes[node].entity = nullEntity;
+
+		return node;
+	}
+
+	void FreeNode(std::int32_t node)
+	{
+		nodes[node].parent = freeList;
+		nodes[node].height = -1;
+
+		freeList = node;
+	}
+
+	void InsertLeaf(std::int32_t leaf)
+	{
+		if (root == nullNode)
+		{
+			root = leaf;
+			nodes[root].parent = nullNode;
+
+			return;
+		}
+
+		AABB leafBounds = nodes[leaf].bounds;
+		std::int32_t sibling = root;
+
+		// Walk down picking the child that grows the least in surface area, stopping once a new parent here is cheaper.
+		while (!nodes[sibling].IsLeaf())
+		{
+			std::int32_t child1 = nodes[sibling].child1;
+			std::int32_t child2 = nodes[sibling].child2;
+
+			float area = nodes[sibling].bounds.GetSurfaceArea();
+			float combinedArea = AABB::Union(nodes[sibling].bounds, leafBounds).GetSurfaceArea();
+
+			float cost = 2.0f * combinedArea;
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			float cost1 = GetDescentCost(child1, leafBounds) + inheritanceCost;
+			float cost2 = GetDescentCost(child2, leafBounds) + inheritanceCost;
+
+			if (cost < cost1 && cost < cost2)
+				break;
+
+			sibling = cost1 < cost2 ? child1 : child2;
+		}
+
+		std::int32_t oldParent = nodes[sibling].parent;
+		std::int32_t newParent = AllocateNode();
+
+		nodes[newParent].parent = oldParent;
+		nodes[newParent].bounds = AABB::Union(leafBounds, nodes[sibling].bounds);
+		nodes[newParent].height = nodes[sibling].height + 1;
+		nodes[newParent].child1 = sibling;
+		nodes[newParent].child2 = leaf;
+
+		nodes[sibling].parent = newParent;
+		nodes[leaf].parent = newParent;
+
+		if (oldParent == nullNode)
+			root = newParent;
+		else if (nodes[oldParent].child1 == sibling)
+			nodes[oldParent].child1 = newParent;
+		else
+			nodes[oldParent].child2 = newParent;
+
+		Refit(nodes[leaf].parent);
+	}
+
+	void RemoveLeaf(std::int32_t leaf)
+	{
+		if (leaf == root)
+		{
+			root = nullNode;
+			return;
+		}
+
+		std::int32_t parent = nodes[leaf].parent;
+		std::int32_t grandParent = nodes[parent].parent;
+		std::int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+		if (grandParent == nullNode)
+		{
+			root = sibling;
+			nodes[sibling].parent = nullNode;
+
+			FreeNode(parent);
+
+			return;
+		}
+
+		if (nodes[grandParent].child1 == parent)
+			nodes[grandParent].child1 = sibling;
+		else
+			nodes[grandParent].child2 = sibling;
+
+		nodes[sibling].parent = grandParent;
+
+		FreeNode(parent);
+		Refit(grandParent);
+	}
+
+	float GetDescentCost(std::int32_t child, const AABB& leafBounds) const
+	{
+		float combinedArea = AABB::Union(leafBounds, nodes[child].bounds).GetSurfaceArea();
+
+		if (nodes[child].IsLeaf())
+			return combinedArea;
+
+		return combinedArea - nodes[child].bounds.GetSurfaceArea();
+	}
+
+	// Walks back up to the root, rebalancing and recomputing bounds and heights on the way.
+	void Refit(std::int32_t node)
+	{
+		while (node != nullNode)
+		{
+			node = Balance(node);
+
+			std::int32_t child1 = nodes[node].child1;
+			std::int32_t child2 = nodes[node].child2;
+
+			nodes[node].height = 1 + glm::max(nodes[child1].height, nodes[child2].height);
+			nodes[node].bounds = AABB::Union(nodes[child1].bounds, nodes[child2].bounds);
+
+			node = nodes[node].parent;
+		}
+	}
+
+	// Rotates the taller grandchild up when the children of a differ in height by more than one; returns the node now at a's place.
+	std::int32_t Balance(std::int32_t a)
+	{
+		if (nodes[a].IsLeaf() || nodes[a].height < 2)
+			return a;
+
+		std::int32_t b = nodes[a].child1;
+		std::int32_t c = nodes[a].child2;
+
+		std::int32_t balance = nodes[c].height - nodes[b].height;
+
+		if (balance > 1)
+			return Rotate(a, c, b);
+
+		if (balance < -1)
+			return Rotate(a, b, c);
+
+		return a;
+	}
+
+	std::int32_t Rotate(std::int32_t a, std::int32_t up, std::int32_t other)
+	{
+		std::int32_t f = nodes[up].child1;
+		std::int32_t g = nodes[up].child2;
+
+		nodes[up].child1 = a;
+		nodes[up].parent = nodes[a].parent;
+		nodes[a].parent = up;
+
+		if (nodes[up].parent == nullNode)
+			root = up;
+		else if (nodes[nodes[up].parent].child1 == a)
+			nodes[nodes[up].parent].child1 = up;
+		else
+			nodes[nodes[up].parent].child2 = up;
+
+		std::int32_t kept = nodes[f].height > nodes[g].height ? f : g;
+		std::int32_t moved = kept == f ? g : f;
+
+		nodes[up].child2 = kept;
+
+		if (nodes[a].child1 == up)
+			nodes[a].child1 = moved;
+		else
+			nodes[a].child2 = moved;
+
+		nodes[moved].parent = a;
+
+		nodes[a].bounds = AABB::Union(nodes[other].bounds, nodes[moved].bounds);
+		nodes[a].height = 1 + glm::max(nodes[other].height, nodes[moved].height);
+
+		nodes[up].bounds = AABB::Union(nodes[a].bounds, nodes[kept].bounds);
+		nodes[up].height = 1 + glm::max(nodes[a].height, nodes[kept].height);
+
+		return up;
+	}
+
+	std::vector<AABBTreeNode> nodes;
+	std::int32_t root = nullNode;
+	std::int32_t freeList = nullNode;
+};
+
+#endif // !DYNAMIC_AABB_TREE_HPP
@@ -0,0 +1,329 @@
+#ifndef GRAVITY_SOLVER_HPP
+#define GRAVITY_SOLVER_HPP
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include "components/RigidBody.hpp"
+#include "core/ECS.hpp"
+
+#define nullOctant -1
+
+struct GravityAttractor
+{
+	glm::vec3 position;
+	float mass;
+};
+
+struct GravityNode
+{
+	glm::vec3 centerOfMass;
+	float mass;
+	float size;
+	float openingDistanceSquared;
+	std::uint32_t begin;
+	std::uint32_t end;
+	std::int32_t children[8];
+};
+
+// Barnes-Hut gravity between every rigid body plus a list of fixed attractors, written into RigidBody::acceleration.
+// Bodies are bucketed into an octree each tick; a node further away than its size divided by theta, plus how far its centre of mass sits off
+// its centre, is treated as one point mass. The offset keeps a node whose mass is bunched on its far side from being accepted by a body right beside it.
+class GravitySolver
+{
+
+public:
+
+	// Runs once per fixed tick, before RigidBodySolver::Step, from the main thread.
+	static void Step()
+	{
+		Gather();
+
+		accelerations.resize(positions.size());
+
+		if (positions.empty())
+			return;
+
+		BuildTree();
+
+		// Bodies are walked in tree order so neighbouring jobs open the same nodes and leaves.
+		auto job = [](std::size_t j)
+		{
+			std::size_t end = std::min(positions.size(), (j + 1) * bodiesPerJob);
+
+			for (std::size_t k = j * bodiesPerJob; k < end; ++k)
+				accelerations[order[k]] = GetAcceleration(sortedPositions[k], static_cast<std::int32_t>(k));
+		};
+
+		std::size_t jobCount = (positions.size() + bodiesPerJob - 1) / bodiesPerJob;
+
+		if (jobCount <= 1 || SystemScheduler::singleThreaded)
+		{
+			for (std::size_t j = 0; j < jobCount; ++j)
+				job(j);
+		}
+		else
+			SystemScheduler::GetThreadPool().Dispatch(jobCount, job);
+
+		float wakeSquared = wakeAcceleration * wakeAcceleration;
+
+		// The rigid body solver skips sleeping bodies, so one left asleep in a field that has since changed would hang in place forever.
+		for (std::size_t i = 0; i < bodies.size(); ++i)
+		{
+			glm::vec3 change = accelerations[i] - bodies[i]->sleepAcceleration;
+
+			bodies[i]->acceleration = accelerations[i];
+
+			if (!bodies[i]->awake && glm::dot(change, change) > wakeSquared)
+				bodies[i]->WakeUp();
+		}
+	}
+
+	static glm::vec3 GetAcceleration(const glm::vec3& position)
+	{
+		return GetAcceleration(position, nullOctant);
+	}
+
+	static std::size_t GetNodeCount()
+	{
+		return nodes.size();
+	}
+
+	static std::vector<GravityAttractor> attractors;
+
+	// Lower theta is more accurate and slower; 0 degenerates to summing every pair.
+	static float theta;
+	static float gravitationalConstant;
+	static float softening;
+
+	// Sleeping bodies wake once the pull on them differs by more than this from the pull they fell asleep under,
+	// so a body resting on the ground under a steady pull stays asleep.
+	static float wakeAcceleration;
+
+	static std::uint32_t leafSize;
+	static std::size_t bodiesPerJob;
+
+private:
+
+	static void Gather()
+	{
+		bodies.clear();
+		positions.clear();
+		masses.clear();
+
+		ECSManager::ForEach<RigidBody>([](RigidBody& body)
+		{
+			bodies.push_back(&body);
+			positions.push_back(body.gameObject->transform.position);
+			masses.push_back(body.mass);
+		});
+	}
+
+	static void BuildTree()
+	{
+		nodes.clear();
+		order.resize(positions.size());
+
+		for (std::uint32_t i = 0; i < order.size(); ++i)
+			order[i] = i;
+
+		glm::vec3 minimum = positions[0];
+		glm::vec3 maximum = positions[0];
+
+		for (const glm::vec3& position : positions)
+		{
+			minimum = glm::min(minimum, position);
+			maximum = glm::max(maximum, position);
+		}
+
+		glm::vec3 extent = maximum - minimum;
+		float size = std::max(std::max(extent.x, extent.y), std::max(extent.z, 1e-3f));
+
+		BuildNode(0, static_cast<std::uint32_t>(order.size()), (minimum + maximum) * 0.5f, size, 0);
+
+		sortedPositions.resize(order.size());
+		sortedMasses.resize(order.size());
+
+		for (std::size_t k = 0; k < order.size(); ++k)
+		{
+			sortedPositions[k] = positions[order[k]];
+			sortedMasses[k] = masses[order[k]];
+		}
+	}
+
+	// Splits order[begin, end) into its eight octants in place, so every node's bodies stay contiguous.
+	static std::int32_t BuildNode(std::uint32_t begin, std::uint32_t end, const glm::vec3& center, float size, int depth)
+	{
+		std::int32_t index = static_cast<std::int32_t>(nodes.size());
+
+		nodes.push_back({ glm::vec3{ 0.0f }, 0.0f, size, 0.0f, begin, end, { nullOctant, nullOctant, nullOctant, nullOctant, nullOctant, nullOctant, nullOctant, nullOctant } });
+
+		if (end - begin > leafSize && depth < maxDepth)
+		{
+			std::uint32_t* first = order.data() + begin;
+			std::uint32_t* last = order.data() + end;
+
+			std::uint32_t* splitX = std::partition(first, last, [&](std::uint32_t i) { return positions[i].x < center.x; });
+			std::uint32_t* splitsY[2] =
+			{
+				std::partition(first, splitX, [&](std::uint32_t i) { return positions[i].y < center.y; }),
+				std::partition(splitX, last, [&](std::uint32_t i) { return positions[i].y < center.y; })
+			};
+
+			std::uint32_t* bounds[9] = { first };
+
+			for (int x = 0; x < 2; ++x)
+			{
+				std::uint32_t* xBegin = x == 0 ? first : splitX;
+				std::uint32_t* xEnd = x == 0 ? splitX : last;
+
+				for (int y = 0; y < 2; ++y)
+				{
+					std::uint32_t* yBegin = y == 0 ? xBegin : splitsY[x];
+					std::uint32_t* yEnd = y == 0 ? splitsY[x] : xEnd;
+					std::uint32_t* splitZ = std::partition(yBegin, yEnd, [&](std::uint32_t i) { return positions[i].z < center.z; });
+
+					bounds[x * 4 + y * 2 + 1] = splitZ;
+					bounds[x * 4 + y * 2 + 2] = yEnd;
+				}
+			}
+
+			float childSize = size * 0.5f;
+
+			for (int octant = 0; octant < 8; ++octant)
+			{
+				if (bounds[octant] == bounds[octant + 1])
+					continue;
+
+				glm::vec3 offset{ octant & 4 ? 1.0f : -1.0f, octant & 2 ? 1.0f : -1.0f, octant & 1 ? 1.0f : -1.0f };
+				std::int32_t child = BuildNode(static_cast<std::uint32_t>(bounds[octant] - order.data()), static_cast<std::uint32_t>(bounds[octant + 1] - order.data()), center + offset * (childSize * 0.5f), childSize, depth + 1);
+
+				nodes[index].children[octant] = child;
+				nodes[index].mass += nodes[child].mass;
+				nodes[index].centerOfMass += nodes[child].centerOfMass * nodes[child].mass;
+			}
+		}
+		else
+		{
+			for (std::uint32_t i = begin; i < end; ++i)
+			{
+				nodes[index].mass += masses[order[i]];
+				nodes[index].centerOfMass += positions[order[i]] * masses[order[i]];
+			}
+		}
+
+		if (nodes[index].mass > 0.0f)
+			nodes[index].centerOfMass /= nodes[index].mass;
+		else
+			nodes[index].centerOfMass = center;
+
+		float openingDistance = size / theta + glm::length(nodes[index].centerOfMass - center);
+
+		nodes[index].openingDistanceSquared = openingDistance * openingDistance;
+
+		return index;
+	}
+
+	static glm::vec3 GetPull(const glm::vec3& position, const glm::vec3& source, float mass)
+	{
+		glm::vec3 offset = source - position;
+		float distanceSquared = glm::dot(offset, offset) + softening * softening;
+
+		return offset * (mass / (distanceSquared * glm::sqrt(distanceSquared)));
+	}
+
+	// Leaves are summed body by body, skipping self (a slot in tree order, or nullOctant for a point in space); the softening term keeps close passes finite.
+	static glm::vec3 GetAcceleration(const glm::vec3& position, std::int32_t self)
+	{
+		glm::vec3 acceleration{ 0.0f };
+
+		for (const GravityAttractor& attractor : attractors)
+			acceleration += GetPull(position, attractor.position, attractor.mass);
+
+		if (!nodes.empty())
+		{
+			std::vector<std::int32_t>& stack = GetStack();
+
+			stack.clear();
+			stack.push_back(0);
+
+			while (!stack.empty())
+			{
+				const GravityNode& node = nodes[stack.back()];
+
+				stack.pop_back();
+
+				glm::vec3 offset = node.centerOfMass - position;
+				float distanceSquared = glm::dot(offset, offset);
+
+				// A node holding the body itself is always opened; at a high enough theta it could otherwise pass the test and pull the body with its own mass.
+				bool holdsSelf = self >= static_cast<std::int32_t>(node.begin) && self < static_cast<std::int32_t>(node.end);
+
+				if (!holdsSelf && node.openingDistanceSquared < distanceSquared)
+				{
+					acceleration += GetPull(position, node.centerOfMass, node.mass);
+					continue;
+				}
+
+				bool leaf = true;
+
+				for (std::int32_t child : node.children)
+				{
+					if (child != nullOctant)
+					{
+						stack.push_back(child);
+						leaf = false;
+					}
+				}
+
+				if (!leaf)
+					continue;
+
+				for (std::uint32_t k = node.begin; k < node.end; ++k)
+				{
+					if (static_cast<std::int32_t>(k) != self)
+						acceleration += GetPull(position, sortedPositions[k], sortedMasses[k]);
+				}
+			}
+		}
+
+		return acceleration * gravitationalConstant;
+	}
+
+	static std::vector<std::int32_t>& GetStack()
+	{
+		thread_local std::vector<std::int32_t> stack;
+
+		return stack;
+	}
+
+	static constexpr int maxDepth = 24;
+
+	static std::vector<RigidBody*> bodies;
+	static std::vector<glm::vec3> positions;
+	static std::vector<float> masses;
+	static std::vector<glm::vec3> accelerations;
+	static std::vector<std::uint32_t> order;
+	static std::vector<glm::vec3> sortedPositions;
+	static std::vector<float> sortedMasses;
+	static std::vector<GravityNode> nodes;
+};
+
+std::vector<GravityAttractor> GravitySolver::attractors;
+float GravitySolver::theta = 0.5f;
+float GravitySolver::gravitationalConstant = 1.0f;
+float GravitySolver::softening = 0.5f;
+float GravitySolver::wakeAcceleration = 0.1f;
+std::uint32_t GravitySolver::leafSize = 8;
+std::size_t GravitySolver::bodiesPerJob = 512;
+std::vector<RigidBody*> GravitySolver::bodies;
+std::vector<glm::vec3> GravitySolver::positions;
+std::vector<float> GravitySolver::masses;
+std::vector<glm::vec3> GravitySolver::accelerations;
+std::vector<std::uint32_t> GravitySolver::order;
+std::vector<glm::vec3> GravitySolver::sortedPositions;
+std::vector<float> GravitySolver::sortedMasses;
+std::vector<GravityNode> GravitySolver::nodes;
+
+#endif // !GRAVITY_SOLVER_HPP
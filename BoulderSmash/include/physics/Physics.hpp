@@ -0,0 +1,179 @@
+#ifndef PHYSICS_HPP
+#define PHYSICS_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <glm/glm.hpp>
+#include "core/ECS.hpp"
+#include "physics/AABB.hpp"
+#include "physics/PhysicsWorld.hpp"
+
+#define allLayers 0xFFFFFFFFu
+
+struct RaycastHit
+{
+	EntityID entity = nullEntity;
+	float distance = 0.0f;
+	glm::vec3 point = glm::vec3{ 0.0f };
+	glm::vec3 normal = glm::vec3{ 0.0f };
+};
+
+struct Ray
+{
+	glm::vec3 origin;
+	glm::vec3 direction;
+	float maxDistance;
+	std::uint32_t layerMask = allLayers;
+};
+
+// Queries against the colliders gathered by the last PhysicsWorld::Step, walked through its AABB tree. Directions must be normalized.
+namespace Physics
+{
+	// Picks the face of bounds the cast entered through; a cast starting inside the box reports the reverse of its direction.
+	glm::vec3 GetNormal(const AABB& bounds, const glm::vec3& point, const glm::vec3& direction, float distance)
+	{
+		if (distance <= 0.0f)
+			return -direction;
+
+		glm::vec3 normal{ 0.0f };
+		float closest = std::numeric_limits<float>::max();
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			float toMin = glm::abs(point[axis] - bounds.min[axis]);
+			float toMax = glm::abs(point[axis] - bounds.max[axis]);
+
+			if (toMin < closest && direction[axis] > 0.0f)
+			{
+				closest = toMin;
+				normal = glm::vec3{ 0.0f };
+				normal[axis] = -1.0f;
+			}
+
+			if (toMax < closest && direction[axis] < 0.0f)
+			{
+				closest = toMax;
+				normal = glm::vec3{ 0.0f };
+				normal[axis] = 1.0f;
+			}
+		}
+
+		return normal;
+	}
+
+	// Casts a box of half size extent along the ray; a zero extent is a plain ray.
+	bool CastExtent(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, const glm::vec3& extent, RaycastHit& hit, std::uint32_t layerMask)
+	{
+		glm::vec3 inverseDirection = 1.0f / direction;
+
+		hit.entity = nullEntity;
+
+		PhysicsWorld::tree.RayCast(origin, direction, maxDistance, [&](std::int32_t proxy, float closest)
+		{
+			std::uint32_t index = PhysicsWorld::tree.GetIndex(proxy);
+
+			if (!(PhysicsWorld::GetLayer(index) & layerMask))
+				return closest;
+
+			const AABB& bounds = PhysicsWorld::GetBounds(index);
+			AABB grown = AABB::Register(bounds.min - extent, bounds.max + extent);
+
+			float distance;
+
+			if (!grown.IntersectsRay(origin, inverseDirection, closest, distance))
+				return closest;
+
+			hit.entity = PhysicsWorld::GetEntity(index);
+			hit.distance = distance;
+			hit.point = origin + direction * distance;
+			hit.normal = GetNormal(grown, hit.point, direction, distance);
+
+			return distance;
+		}, extent);
+
+		return hit.entity != nullEntity;
+	}
+
+	bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit, std::uint32_t layerMask = allLayers)
+	{
+		return CastExtent(origin, direction, maxDistance, glm::vec3{ 0.0f }, hit, layerMask);
+	}
+
+	// Collects every collider along the ray, nearest first.
+	void RaycastAll(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<RaycastHit>& hits, std::uint32_t layerMask = allLayers)
+	{
+		glm::vec3 inverseDirection = 1.0f / direction;
+
+		hits.clear();
+
+		PhysicsWorld::tree.RayCast(origin, direction, maxDistance, [&](std::int32_t proxy, float closest)
+		{
+			std::uint32_t index = PhysicsWorld::tree.GetIndex(proxy);
+
+			float distance;
+
+			if ((PhysicsWorld::GetLayer(index) & layerMask) && PhysicsWorld::GetBounds(index).IntersectsRay(origin, inverseDirection, closest, distance))
+			{
+				RaycastHit hit;
+
+				hit.entity = PhysicsWorld::GetEntity(index);
+				hit.distance = distance;
+				hit.point = origin + direction * distance;
+				hit.normal = GetNormal(PhysicsWorld::GetBounds(index), hit.point, direction, distance);
+
+				hits.push_back(hit);
+			}
+
+			return closest;
+		});
+
+		std::sort(hits.begin(), hits.end(), [](const RaycastHit& a, const RaycastHit& b)
+		{
+			return a.distance < b.distance;
+		});
+	}
+
+	// The sphere is treated as its bounding cube, so hits near box edges and corners are slightly early.
+	bool SphereCast(const glm::vec3& origin, float radius, const glm::vec3& direction, float maxDistance, RaycastHit& hit, std::uint32_t layerMask = allLayers)
+	{
+		return CastExtent(origin, direction, maxDistance, glm::vec3{ radius }, hit, layerMask);
+	}
+
+	bool BoxCast(const glm::vec3& center, const glm::vec3& halfExtent, const glm::vec3& direction, float maxDistance, RaycastHit& hit, std::uint32_t layerMask = allLayers)
+	{
+		return CastExtent(center, direction, maxDistance, halfExtent, hit, layerMask);
+	}
+
+	// Runs many rays across the scheduler's worker pool, e.g. shotgun pellets or line-of-sight checks; misses have a null entity.
+	// Must be called from the main thread between physics steps, not from inside a system.
+	void RaycastBatch(const std::vector<Ray>& rays, std::vector<RaycastHit>& hits)
+	{
+		constexpr std::size_t raysPerJob = 32;
+
+		hits.resize(rays.size());
+
+		auto job = [&](std::size_t j)
+		{
+			std::size_t end = std::min(rays.size(), (j + 1) * raysPerJob);
+
+			for (std::size_t r = j * raysPerJob; r < end; ++r)
+				Raycast(rays[r].origin, rays[r].direction, rays[r].maxDistance, hits[r], rays[r].layerMask);
+		};
+
+		std::size_t jobCount = (rays.size() + raysPerJob - 1) / raysPerJob;
+
+		if (jobCount <= 1 || SystemScheduler::singleThreaded)
+		{
+			for (std::size_t j = 0; j < jobCount; ++j)
+				job(j);
+
+			return;
+		}
+
+		SystemScheduler::GetThreadPool().Dispatch(jobCount, job);
+	}
+}
+
+#endif // !PHYSICS_HPP
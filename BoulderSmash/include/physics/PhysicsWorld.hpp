@@ -0,0 +1,285 @@
+#ifndef PHYSICS_WORLD_HPP
+#define PHYSICS_WORLD_HPP
+
+#include <vector>
+#include "components/BoxCollider.hpp"
+#include "components/RigidBody.hpp"
+#include "core/ECS.hpp"
+#include "physics/AABB.hpp"
+#include "physics/AABBBatch.hpp"
+#include "physics/CollisionPairCache.hpp"
+#include "physics/DynamicAABBTree.hpp"
+#include "physics/SpatialHashGrid.hpp"
+
+enum class BroadphaseType
+{
+	SPATIAL_HASH,
+	AABB_TREE
+};
+
+class PhysicsWorld
+{
+
+public:
+
+	// Runs once per fixed tick, after the ECS update, so colliders have already been synced to their GameObjects.
+	// Rigid bodies have not moved yet: they are swept over where their velocity takes them during deltaTime.
+	static void Step(float deltaTime)
+	{
+		bounds.clear();
+		startBounds.clear();
+		sweptBounds.clear();
+		displacements.clear();
+		continuous.clear();
+		layers.clear();
+		entities.clear();
+		batch.Clear();
+
+		ECSManager::ForEach<BoxCollider>([deltaTime](BoxCollider& collider)
+		{
+			GameObject& gameObject = *collider.gameObject;
+			glm::vec3 moved = gameObject.transform.position - gameObject.previousTransform.position;
+			glm::vec3 displacement = moved;
+
+			if (gameObject.HasComponent<RigidBody>())
+			{
+				const RigidBody& body = gameObject.GetComponent<RigidBody>();
+
+				if (body.awake)
+					displacement += body.linearVelocity * deltaTime;
+			}
+
+			bounds.push_back(collider.GetBounds());
+			startBounds.push_back(AABB::Register(bounds.back().min - moved, bounds.back().max - moved));
+			displacements.push_back(displacement);
+			continuous.push_back(collider.continuous);
+			layers.push_back(collider.layer);
+			entities.push_back(gameObject.GetID());
+			batch.Add(bounds.back());
+
+			// Fast colliders enter the broadphase with the whole volume they sweep this tick so nothing they pass through is missed.
+			if (collider.continuous)
+				sweptBounds.push_back(AABB::Union(AABB::Union(startBounds.back(), bounds.back()), AABB::Register(startBounds.back().min + displacement, startBounds.back().max + displacement)));
+			else
+				sweptBounds.push_back(bounds.back());
+
+			UpdateProxy(gameObject.GetID(), sweptBounds.back(), displacement);
+		});
+
+		RemoveStaleProxies();
+
+		if (broadphaseType == BroadphaseType::SPATIAL_HASH)
+			broadphase.FindPairs(sweptBounds, pairs);
+		else
+			FindTreePairs();
+
+		ResolveContinuousPairs();
+
+		for (const ColliderPair& pair : pairs)
+			pairCache.AddPair(entities[pair.a], entities[pair.b]);
+
+		pairCache.Update(collisionEvents);
+	}
+
+	// Events from every tick since the last clear, in tick order; the buffer keeps its capacity so steady contact counts never allocate.
+	static const std::vector<CollisionEvent>& GetCollisionEvents()
+	{
+		return collisionEvents;
+	}
+
+	// Called once per frame after gameplay has read the events.
+	static void ClearCollisionEvents()
+	{
+		collisionEvents.clear();
+	}
+
+	// Collects every collider whose bounds overlap the given box, e.g. to find what is near the camera.
+	static void Query(const AABB& area, std::vector<EntityID>& results)
+	{
+		results.clear();
+
+		tree.Query(area, [&](std::int32_t proxy)
+		{
+			if (bounds[tree.GetIndex(proxy)].Overlaps(area))
+				results.push_back(tree.GetEntity(proxy));
+
+			return true;
+		});
+	}
+
+	// Tests area against every collider at once; bit i of mask is set when collider i from this tick overlaps.
+	static void OverlapAll(const AABB& area, std::vector<std::uint64_t>& mask)
+	{
+		AABBOverlap::Test(area, batch, mask);
+	}
+
+	static const std::vector<ColliderPair>& GetPairs()
+	{
+		return pairs;
+	}
+
+	// Fraction of the tick at which pair first touches, counted from where the colliders started it; 1 for pairs between discrete colliders,
+	// which are only tested where they are now.
+	static float GetTimeOfImpact(std::size_t pair)
+	{
+		return timesOfImpact[pair];
+	}
+
+	static EntityID GetEntity(std::uint32_t proxy)
+	{
+		return entities[proxy];
+	}
+
+	static const AABB& GetBounds(std::uint32_t proxy)
+	{
+		return bounds[proxy];
+	}
+
+	// How far the collider moves over the tick, both what gameplay already moved it and what its rigid body is about to.
+	static const glm::vec3& GetDisplacement(std::uint32_t proxy)
+	{
+		return displacements[proxy];
+	}
+
+	static std::uint32_t GetLayer(std::uint32_t proxy)
+	{
+		return layers[proxy];
+	}
+
+	static BroadphaseType broadphaseType;
+	static SpatialHashGrid broadphase;
+	static DynamicAABBTree tree;
+
+private:
+
+	static void UpdateProxy(EntityID entity, const AABB& colliderBounds, const glm::vec3& displacement)
+	{
+		std::uint32_t index = static_cast<std::uint32_t>(bounds.size() - 1);
+		std::uint32_t entityIndex = GetEntityIndex(entity);
+
+		if (entityProxies.size() <= entityIndex)
+			entityProxies.resize(entityIndex + 1, nullNode);
+
+		std::int32_t& proxy = entityProxies[entityIndex];
+
+		if (proxy == nullNode || tree.GetEntity(proxy) != entity)
+			proxy = tree.CreateProxy(colliderBounds, entity, index);
+		else
+		{
+			tree.MoveProxy(proxy, colliderBounds, displacement);
+			tree.SetIndex(proxy, index);
+		}
+
+		if (proxyStamps.size() <= static_cast<std::size_t>(proxy))
+			proxyStamps.resize(proxy + 1, 0);
+
+		proxyStamps[proxy] = stamp;
+	}
+
+	// Proxies not visited this tick belong to destroyed entities or removed colliders.
+	static void RemoveStaleProxies()
+	{
+		staleProxies.clear();
+
+		tree.ForEachProxy([](std::int32_t proxy)
+		{
+			if (proxyStamps[proxy] != stamp)
+				staleProxies.push_back(proxy);
+		});
+
+		for (std::int32_t proxy : staleProxies)
+		{
+			std::uint32_t entityIndex = GetEntityIndex(tree.GetEntity(proxy));
+
+			if (entityProxies[entityIndex] == proxy)
+				entityProxies[entityIndex] = nullNode;
+
+			tree.DestroyProxy(proxy);
+		}
+
+		stamp++;
+	}
+
+	static void FindTreePairs()
+	{
+		pairs.clear();
+
+		for (std::uint32_t i = 0; i < sweptBounds.size(); ++i)
+		{
+			tree.Query(sweptBounds[i], [i](std::int32_t proxy)
+			{
+				std::uint32_t j = tree.GetIndex(proxy);
+
+				if (j > i && sweptBounds[i].Overlaps(sweptBounds[j]))
+					pairs.push_back({ i, j });
+
+				return true;
+			});
+		}
+	}
+
+	// Candidates involving a fast collider only overlapped as swept volumes; keep those whose boxes actually meet during the tick.
+	static void ResolveContinuousPairs()
+	{
+		timesOfImpact.clear();
+
+		std::size_t kept = 0;
+
+		for (const ColliderPair& pair : pairs)
+		{
+			float timeOfImpact = 1.0f;
+
+			if (continuous[pair.a] || continuous[pair.b])
+			{
+				if (!AABB::Sweep(startBounds[pair.a], displacements[pair.a], startBounds[pair.b], displacements[pair.b], timeOfImpact))
+					continue;
+			}
+
+			pairs[kept++] = pair;
+			timesOfImpact.push_back(timeOfImpact);
+		}
+
+		pairs.resize(kept);
+	}
+
+	static std::vector<AABB> bounds;
+	static std::vector<AABB> startBounds;
+	static std::vector<AABB> sweptBounds;
+	static std::vector<glm::vec3> displacements;
+	static std::vector<bool> continuous;
+	static std::vector<std::uint32_t> layers;
+	static std::vector<float> timesOfImpact;
+	static AABBBatch batch;
+	static std::vector<EntityID> entities;
+	static std::vector<ColliderPair> pairs;
+
+	static CollisionPairCache pairCache;
+	static std::vector<CollisionEvent> collisionEvents;
+
+	static std::vector<std::int32_t> entityProxies;
+	static std::vector<std::uint32_t> proxyStamps;
+	static std::vector<std::int32_t> staleProxies;
+	static std::uint32_t stamp;
+};
+
+BroadphaseType PhysicsWorld::broadphaseType = BroadphaseType::SPATIAL_HASH;
+SpatialHashGrid PhysicsWorld::broadphase;
+DynamicAABBTree PhysicsWorld::tree;
+std::vector<AABB> PhysicsWorld::bounds;
+std::vector<AABB> PhysicsWorld::startBounds;
+std::vector<AABB> PhysicsWorld::sweptBounds;
+std::vector<glm::vec3> PhysicsWorld::displacements;
+std::vector<bool> PhysicsWorld::continuous;
+std::vector<std::uint32_t> PhysicsWorld::layers;
+std::vector<float> PhysicsWorld::timesOfImpact;
+AABBBatch PhysicsWorld::batch;
+std::vector<EntityID> PhysicsWorld::entities;
+std::vector<ColliderPair> PhysicsWorld::pairs;
+CollisionPairCache PhysicsWorld::pairCache;
+std::vector<CollisionEvent> PhysicsWorld::collisionEvents;
+std::vector<std::int32_t> PhysicsWorld::entityProxies;
+std::vector<std::uint32_t> PhysicsWorld::proxyStamps;
+std::vector<std::int32_t> PhysicsWorld::staleProxies;
+std::uint32_t PhysicsWorld::stamp = 1;
+
+#endif // !PHYSICS_WORLD_HPP
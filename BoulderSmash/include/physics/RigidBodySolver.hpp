@@ -0,0 +1,524 @@
+#ifndef RIGID_BODY_SOLVER_HPP
+#define RIGID_BODY_SOLVER_HPP
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include "components/RigidBody.hpp"
+#include "core/ECS.hpp"
+#include "physics/PhysicsWorld.hpp"
+
+#define staticBody -1
+
+struct RigidBodyContact
+{
+	std::int32_t a;
+	std::int32_t b;
+	glm::vec3 normal;
+	float penetration;
+	float bias;
+	float normalImpulse;
+};
+
+// Resolves the contacts PhysicsWorld::Step found between rigid bodies with sequential impulses, then integrates them.
+// Touching bodies form islands that are solved in parallel and fall asleep together; sleeping and out of range bodies are skipped.
+class RigidBodySolver
+{
+
+public:
+
+	// Runs once per fixed tick, straight after PhysicsWorld::Step, from the main thread.
+	static void Step(float deltaTime)
+	{
+		Gather();
+		BuildContacts();
+		BuildIslands();
+		SolveIslands(deltaTime);
+		Scatter();
+	}
+
+	static std::size_t GetBodyCount()
+	{
+		return bodies.size();
+	}
+
+	static std::size_t GetAwakeBodyCount()
+	{
+		return islandBodies.size();
+	}
+
+	static std::size_t GetIslandCount()
+	{
+		return islandStarts.empty() ? 0 : islandStarts.size() - 1;
+	}
+
+	// Bodies further than simulationRadius from focus are frozen in place and act as static obstacles.
+	static glm::vec3 focus;
+	static float simulationRadius;
+
+	static int velocityIterations;
+	static float baumgarte;
+	static float penetrationSlop;
+	static float restitutionThreshold;
+
+	static float linearSleepTolerance;
+	static float angularSleepTolerance;
+	static float timeToSleep;
+
+	static std::size_t bodiesPerJob;
+
+private:
+
+	static void Gather()
+	{
+		bodies.clear();
+		gameObjects.clear();
+		positions.clear();
+		linearVelocities.clear();
+		angularVelocities.clear();
+		accelerations.clear();
+		angles.clear();
+		inverseMasses.clear();
+		restitutions.clear();
+		dampings.clear();
+		sleepTimes.clear();
+		awake.clear();
+
+		std::fill(entityBodies.begin(), entityBodies.end(), staticBody);
+
+		float radiusSquared = simulationRadius * simulationRadius;
+
+		ECSManager::ForEach<RigidBody>([radiusSquared](RigidBody& body)
+		{
+			GameObject& gameObject = *body.gameObject;
+			glm::vec3 offset = gameObject.transform.position - focus;
+
+			if (glm::dot(offset, offset) > radiusSquared)
+				return;
+
+			std::uint32_t entityIndex = GetEntityIndex(gameObject.GetID());
+
+			if (entityBodies.size() <= entityIndex)
+				entityBodies.resize(entityIndex + 1, staticBody);
+
+			entityBodies[entityIndex] = static_cast<std::int32_t>(bodies.size());
+
+			bodies.push_back(&body);
+			gameObjects.push_back(&gameObject);
+			positions.push_back(gameObject.transform.position);
+			linearVelocities.push_back(body.linearVelocity);
+			angularVelocities.push_back(body.angularVelocity);
+			accelerations.push_back(body.acceleration);
+			angles.push_back(gameObject.transform.rotation.w);
+			inverseMasses.push_back(body.mass > 0.0f ? 1.0f / body.mass : 0.0f);
+			restitutions.push_back(body.restitution);
+			dampings.push_back(body.linearDamping);
+			sleepTimes.push_back(body.sleepTime);
+			awake.push_back(body.awake);
+		});
+	}
+
+	static std::int32_t GetBody(EntityID entity)
+	{
+		std::uint32_t entityIndex = GetEntityIndex(entity);
+
+		return entityIndex < entityBodies.size() ? entityBodies[entityIndex] : staticBody;
+	}
+
+	// Boxes never rotate in the broadphase, so each contact pushes along the axis of least penetration.
+	// Continuous pairs that only meet later in the tick get a speculative contact with a negative penetration: the gap between them,
+	// along the axis they close last, which the solver lets them cover but no more, so a fast body stops at a thin wall instead of passing it.
+	static void BuildContacts()
+	{
+		contacts.clear();
+
+		const std::vector<ColliderPair>& pairs = PhysicsWorld::GetPairs();
+
+		for (std::size_t p = 0; p < pairs.size(); ++p)
+		{
+			const ColliderPair& pair = pairs[p];
+
+			std::int32_t a = GetBody(PhysicsWorld::GetEntity(pair.a));
+			std::int32_t b = GetBody(PhysicsWorld::GetEntity(pair.b));
+
+			if (a == staticBody && b == staticBody)
+				continue;
+
+			if ((a == staticBody || !awake[a]) && (b == staticBody || !awake[b]))
+				continue;
+
+			const AABB& boundsA = PhysicsWorld::GetBounds(pair.a);
+			const AABB& boundsB = PhysicsWorld::GetBounds(pair.b);
+
+			glm::vec3 overlap = glm::min(boundsA.max, boundsB.max) - glm::max(boundsA.min, boundsB.min);
+			int axis;
+
+			if (overlap.x > 0.0f && overlap.y > 0.0f && overlap.z > 0.0f)
+				axis = overlap.x < overlap.y ? (overlap.x < overlap.z ? 0 : 2) : (overlap.y < overlap.z ? 1 : 2);
+			else if (PhysicsWorld::GetTimeOfImpact(p) < 1.0f)
+				axis = GetClosingAxis(overlap, PhysicsWorld::GetDisplacement(pair.b) - PhysicsWorld::GetDisplacement(pair.a));
+			else
+				continue;
+
+			if (axis == -1)
+				continue;
+
+			glm::vec3 normal{ 0.0f };
+			normal[axis] = (boundsB.min[axis] + boundsB.max[axis]) >= (boundsA.min[axis] + boundsA.max[axis]) ? 1.0f : -1.0f;
+
+			contacts.push_back({ a, b, normal, overlap[axis], 0.0f, 0.0f });
+		}
+	}
+
+	// Of the axes two boxes are apart on, the one whose gap the relative motion closes last, or -1 when a gap never closes.
+	static int GetClosingAxis(const glm::vec3& overlap, const glm::vec3& relativeDisplacement)
+	{
+		int axis = -1;
+		float latest = -1.0f;
+
+		for (int i = 0; i < 3; ++i)
+		{
+			if (overlap[i] > 0.0f)
+				continue;
+
+			float speed = std::abs(relativeDisplacement[i]);
+
+			if (speed <= 0.0f)
+				return -1;
+
+			float entry = -overlap[i] / speed;
+
+			if (entry > latest)
+			{
+				latest = entry;
+				axis = i;
+			}
+		}
+
+		return axis;
+	}
+
+	static std::int32_t FindRoot(std::int32_t body)
+	{
+		while (islandParents[body] != body)
+		{
+			islandParents[body] = islandParents[islandParents[body]];
+			body = islandParents[body];
+		}
+
+		return body;
+	}
+
+	// Unions bodies through their contacts and lays each awake island out contiguously, bodies and contacts alike.
+	static void BuildIslands()
+	{
+		std::size_t bodyCount = bodies.size();
+
+		islandParents.resize(bodyCount);
+
+		for (std::size_t i = 0; i < bodyCount; ++i)
+			islandParents[i] = static_cast<std::int32_t>(i);
+
+		for (const RigidBodyContact& contact : contacts)
+		{
+			if (contact.a == staticBody || contact.b == staticBody)
+				continue;
+
+			std::int32_t rootA = FindRoot(contact.a);
+			std::int32_t rootB = FindRoot(contact.b);
+
+			if (rootA != rootB)
+				islandParents[rootA] = rootB;
+		}
+
+		// A sleeping body touched by an awake one wakes with the rest of its island.
+		islandAwake.assign(bodyCount, 0);
+
+		for (std::size_t i = 0; i < bodyCount; ++i)
+			if (awake[i])
+				islandAwake[FindRoot(static_cast<std::int32_t>(i))] = 1;
+
+		islandIds.assign(bodyCount, staticBody);
+		islandStarts.clear();
+
+		std::int32_t islandCount = 0;
+
+		for (std::size_t i = 0; i < bodyCount; ++i)
+		{
+			std::int32_t root = FindRoot(static_cast<std::int32_t>(i));
+
+			if (!islandAwake[root])
+				continue;
+
+			if (islandIds[root] == staticBody)
+				islandIds[root] = islandCount++;
+
+			islandIds[i] = islandIds[root];
+		}
+
+		islandStarts.assign(islandCount + 1, 0);
+		contactStarts.assign(islandCount + 1, 0);
+
+		for (std::size_t i = 0; i < bodyCount; ++i)
+			if (islandIds[i] != staticBody)
+				islandStarts[islandIds[i] + 1]++;
+
+		for (const RigidBodyContact& contact : contacts)
+			contactStarts[GetContactIsland(contact) + 1]++;
+
+		for (std::int32_t i = 0; i < islandCount; ++i)
+		{
+			islandStarts[i + 1] += islandStarts[i];
+			contactStarts[i + 1] += contactStarts[i];
+		}
+
+		islandBodies.resize(islandStarts.back());
+		islandContacts.resize(contactStarts.back());
+		cursors.assign(islandStarts.begin(), islandStarts.end() - 1);
+
+		for (std::size_t i = 0; i < bodyCount; ++i)
+		{
+			if (islandIds[i] == staticBody)
+				continue;
+
+			islandBodies[cursors[islandIds[i]]++] = static_cast<std::int32_t>(i);
+
+			if (!awake[i])
+			{
+				awake[i] = 1;
+				sleepTimes[i] = 0.0f;
+			}
+		}
+
+		cursors.assign(contactStarts.begin(), contactStarts.end() - 1);
+
+		for (const RigidBodyContact& contact : contacts)
+			islandContacts[cursors[GetContactIsland(contact)]++] = contact;
+	}
+
+	static std::int32_t GetContactIsland(const RigidBodyContact& contact)
+	{
+		return islandIds[contact.a == staticBody ? contact.b : contact.a];
+	}
+
+	// Packs whole islands into jobs of roughly bodiesPerJob bodies so a field of lone asteroids is not one job each.
+	static void SolveIslands(float deltaTime)
+	{
+		jobStarts.clear();
+
+		std::size_t islandCount = GetIslandCount();
+		std::size_t jobBodies = bodiesPerJob;
+
+		for (std::size_t island = 0; island < islandCount; ++island)
+		{
+			if (jobBodies >= bodiesPerJob)
+			{
+				jobStarts.push_back(static_cast<std::uint32_t>(island));
+				jobBodies = 0;
+			}
+
+			jobBodies += islandStarts[island + 1] - islandStarts[island];
+		}
+
+		jobStarts.push_back(static_cast<std::uint32_t>(islandCount));
+
+		auto job = [deltaTime](std::size_t j)
+		{
+			for (std::uint32_t island = jobStarts[j]; island < jobStarts[j + 1]; ++island)
+				SolveIsland(island, deltaTime);
+		};
+
+		std::size_t jobCount = jobStarts.size() - 1;
+
+		if (jobCount <= 1 || SystemScheduler::singleThreaded)
+		{
+			for (std::size_t j = 0; j < jobCount; ++j)
+				job(j);
+
+			return;
+		}
+
+		SystemScheduler::GetThreadPool().Dispatch(jobCount, job);
+	}
+
+	static void SolveIsland(std::uint32_t island, float deltaTime)
+	{
+		static const glm::vec3 zero{ 0.0f };
+
+		RigidBodyContact* islandContactsBegin = islandContacts.data() + contactStarts[island];
+		RigidBodyContact* islandContactsEnd = islandContacts.data() + contactStarts[island + 1];
+
+		for (std::uint32_t i = islandStarts[island]; i < islandStarts[island + 1]; ++i)
+			linearVelocities[islandBodies[i]] += accelerations[islandBodies[i]] * deltaTime;
+
+		for (RigidBodyContact* contact = islandContactsBegin; contact != islandContactsEnd; ++contact)
+		{
+			const glm::vec3& velocityA = contact->a == staticBody ? zero : linearVelocities[contact->a];
+			const glm::vec3& velocityB = contact->b == staticBody ? zero : linearVelocities[contact->b];
+
+			float restitution = std::max(contact->a == staticBody ? 0.0f : restitutions[contact->a], contact->b == staticBody ? 0.0f : restitutions[contact->b]);
+			float approach = glm::dot(velocityB - velocityA, contact->normal);
+			float bounce = approach < -restitutionThreshold ? -restitution * approach : 0.0f;
+
+			// A speculative contact's bias is negative: the approach speed that just closes the gap by the end of the tick.
+			if (contact->penetration < 0.0f)
+				contact->bias = contact->penetration / deltaTime;
+			else
+				contact->bias = std::max(bounce, baumgarte / deltaTime * std::max(contact->penetration - penetrationSlop, 0.0f));
+			contact->normalImpulse = 0.0f;
+		}
+
+		for (int iteration = 0; iteration < velocityIterations; ++iteration)
+		{
+			for (RigidBodyContact* contact = islandContactsBegin; contact != islandContactsEnd; ++contact)
+			{
+				float inverseMassA = contact->a == staticBody ? 0.0f : inverseMasses[contact->a];
+				float inverseMassB = contact->b == staticBody ? 0.0f : inverseMasses[contact->b];
+				float inverseMassSum = inverseMassA + inverseMassB;
+
+				if (inverseMassSum <= 0.0f)
+					continue;
+
+				glm::vec3 velocityA = contact->a == staticBody ? zero : linearVelocities[contact->a];
+				glm::vec3 velocityB = contact->b == staticBody ? zero : linearVelocities[contact->b];
+
+				float lambda = (contact->bias - glm::dot(velocityB - velocityA, contact->normal)) / inverseMassSum;
+				float accumulated = std::max(contact->normalImpulse + lambda, 0.0f);
+
+				lambda = accumulated - contact->normalImpulse;
+				contact->normalImpulse = accumulated;
+
+				if (contact->a != staticBody)
+					linearVelocities[contact->a] -= contact->normal * (lambda * inverseMassA);
+
+				if (contact->b != staticBody)
+					linearVelocities[contact->b] += contact->normal * (lambda * inverseMassB);
+			}
+		}
+
+		float linearToleranceSquared = linearSleepTolerance * linearSleepTolerance;
+		float angularToleranceSquared = angularSleepTolerance * angularSleepTolerance;
+		float islandSleepTime = std::numeric_limits<float>::max();
+
+		for (std::uint32_t i = islandStarts[island]; i < islandStarts[island + 1]; ++i)
+		{
+			std::int32_t body = islandBodies[i];
+
+			linearVelocities[body] *= 1.0f / (1.0f + deltaTime * dampings[body]);
+			positions[body] += linearVelocities[body] * deltaTime;
+			angles[body] += glm::length(angularVelocities[body]) * deltaTime;
+
+			if (glm::dot(linearVelocities[body], linearVelocities[body]) > linearToleranceSquared || glm::dot(angularVelocities[body], angularVelocities[body]) > angularToleranceSquared)
+				sleepTimes[body] = 0.0f;
+			else
+				sleepTimes[body] += deltaTime;
+
+			islandSleepTime = std::min(islandSleepTime, sleepTimes[body]);
+		}
+
+		if (islandSleepTime < timeToSleep)
+			return;
+
+		for (std::uint32_t i = islandStarts[island]; i < islandStarts[island + 1]; ++i)
+		{
+			std::int32_t body = islandBodies[i];
+
+			awake[body] = 0;
+			linearVelocities[body] = glm::vec3{ 0.0f };
+			angularVelocities[body] = glm::vec3{ 0.0f };
+		}
+	}
+
+	// Only bodies that were simulated this tick are written back; sleeping ones keep their components untouched.
+	static void Scatter()
+	{
+		for (std::int32_t body : islandBodies)
+		{
+			GameObject& gameObject = *gameObjects[body];
+			RigidBody& rigidBody = *bodies[body];
+
+			gameObject.transform.position = positions[body];
+
+			// Transform keeps an angle in w and the axis in xyz, so a spin is stored as its speed's direction and the angle turned so far.
+			if (glm::dot(angularVelocities[body], angularVelocities[body]) > 0.0f)
+			{
+				glm::vec3 axis = glm::normalize(angularVelocities[body]);
+
+				gameObject.transform.rotation = glm::quat{ angles[body], axis.x, axis.y, axis.z };
+			}
+
+			rigidBody.linearVelocity = linearVelocities[body];
+			rigidBody.angularVelocity = angularVelocities[body];
+			rigidBody.sleepTime = sleepTimes[body];
+			rigidBody.awake = awake[body] != 0;
+
+			if (!rigidBody.awake)
+				rigidBody.sleepAcceleration = accelerations[body];
+		}
+	}
+
+	static std::vector<RigidBody*> bodies;
+	static std::vector<GameObject*> gameObjects;
+	static std::vector<glm::vec3> positions;
+	static std::vector<glm::vec3> linearVelocities;
+	static std::vector<glm::vec3> angularVelocities;
+	static std::vector<glm::vec3> accelerations;
+	static std::vector<float> angles;
+	static std::vector<float> inverseMasses;
+	static std::vector<float> restitutions;
+	static std::vector<float> dampings;
+	static std::vector<float> sleepTimes;
+	static std::vector<std::uint8_t> awake;
+
+	static std::vector<std::int32_t> entityBodies;
+	static std::vector<RigidBodyContact> contacts;
+
+	static std::vector<std::int32_t> islandParents;
+	static std::vector<std::uint8_t> islandAwake;
+	static std::vector<std::int32_t> islandIds;
+	static std::vector<std::uint32_t> islandStarts;
+	static std::vector<std::uint32_t> contactStarts;
+	static std::vector<std::int32_t> islandBodies;
+	static std::vector<RigidBodyContact> islandContacts;
+	static std::vector<std::uint32_t> cursors;
+	static std::vector<std::uint32_t> jobStarts;
+};
+
+glm::vec3 RigidBodySolver::focus = glm::vec3{ 0.0f };
+float RigidBodySolver::simulationRadius = std::numeric_limits<float>::max();
+int RigidBodySolver::velocityIterations = 8;
+float RigidBodySolver::baumgarte = 0.2f;
+float RigidBodySolver::penetrationSlop = 0.01f;
+float RigidBodySolver::restitutionThreshold = 1.0f;
+float RigidBodySolver::linearSleepTolerance = 0.05f;
+float RigidBodySolver::angularSleepTolerance = 0.05f;
+float RigidBodySolver::timeToSleep = 0.5f;
+std::size_t RigidBodySolver::bodiesPerJob = 256;
+std::vector<RigidBody*> RigidBodySolver::bodies;
+std::vector<GameObject*> RigidBodySolver::gameObjects;
+std::vector<glm::vec3> RigidBodySolver::positions;
+std::vector<glm::vec3> RigidBodySolver::linearVelocities;
+std::vector<glm::vec3> RigidBodySolver::angularVelocities;
+std::vector<glm::vec3> RigidBodySolver::accelerations;
+std::vector<float> RigidBodySolver::angles;
+std::vector<float> RigidBodySolver::inverseMasses;
+std::vector<float> RigidBodySolver::restitutions;
+std::vector<float> RigidBodySolver::dampings;
+std::vector<float> RigidBodySolver::sleepTimes;
+std::vector<std::uint8_t> RigidBodySolver::awake;
+std::vector<std::int32_t> RigidBodySolver::entityBodies;
+std::vector<RigidBodyContact> RigidBodySolver::contacts;
+std::vector<std::int32_t> RigidBodySolver::islandParents;
+std::vector<std::uint8_t> RigidBodySolver::islandAwake;
+std::vector<std::int32_t> RigidBodySolver::islandIds;
+std::vector<std::uint32_t> RigidBodySolver::islandStarts;
+std::vector<std::uint32_t> RigidBodySolver::contactStarts;
+std::vector<std::int32_t> RigidBodySolver::islandBodies;
+std::vector<RigidBodyContact> RigidBodySolver::islandContacts;
+std::vector<std::uint32_t> RigidBodySolver::cursors;
+std::vector<std::uint32_t> RigidBodySolver::jobStarts;
+
+#endif // !RIGID_BODY_SOLVER_HPP
@@ -0,0 +1,143 @@
+#ifndef SPATIAL_HASH_GRID_HPP
+#define SPATIAL_HASH_GRID_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <glm/glm.hpp>
+#include "physics/AABB.hpp"
+
+struct ColliderPair
+{
+	std::uint32_t a;
+	std::uint32_t b;
+};
+
+class SpatialHashGrid
+{
+
+public:
+
+	SpatialHashGrid(float cellSize = 16.0f) : cellSize(cellSize) { }
+
+	// Buckets every box into the cells it covers and reports each overlapping pair once, as indices into bounds with a < b.
+	void FindPairs(const std::vector<AABB>& bounds, std::vector<ColliderPair>& pairs)
+	{
+		pairs.clear();
+		entries.clear();
+
+		float inverseCellSize = 1.0f / cellSize;
+
+		for (std::uint32_t b = 0; b < bounds.size(); ++b)
+		{
+			glm::ivec3 minCell = GetCell(bounds[b].min, inverseCellSize);
+			glm::ivec3 maxCell = GetCell(bounds[b].max, inverseCellSize);
+
+			for (int x = minCell.x; x <= maxCell.x; ++x)
+			{
+				for (int y = minCell.y; y <= maxCell.y; ++y)
+				{
+					for (int z = minCell.z; z <= maxCell.z; ++z)
+						entries.push_back({ GetCellKey({ x, y, z }), b });
+				}
+			}
+		}
+
+		SortEntries();
+
+		for (std::size_t bucket = 0; bucket + 1 < bucketStarts.size(); ++bucket)
+		{
+			std::uint32_t begin = bucketStarts[bucket];
+			std::uint32_t end = bucketStarts[bucket + 1];
+
+			for (std::uint32_t i = begin; i < end; ++i)
+			{
+				const CellEntry& first = sortedEntries[i];
+
+				for (std::uint32_t j = i + 1; j < end; ++j)
+				{
+					const CellEntry& second = sortedEntries[j];
+
+					if (first.key != second.key)
+						continue;
+
+					const AABB& a = bounds[first.index];
+					const AABB& b = bounds[second.index];
+
+					if (!a.Overlaps(b))
+						continue;
+
+					// A pair sharing several cells is only reported from the cell holding the corner where the two boxes start to overlap.
+					if (GetCellKey(GetCell(glm::max(a.min, b.min), inverseCellSize)) != first.key)
+						continue;
+
+					if (first.index < second.index)
+						pairs.push_back({ first.index, second.index });
+					else
+						pairs.push_back({ second.index, first.index });
+				}
+			}
+		}
+	}
+
+	float cellSize;
+
+private:
+
+	struct CellEntry
+	{
+		std::uint64_t key;
+		std::uint32_t index;
+	};
+
+	static glm::ivec3 GetCell(const glm::vec3& position, float inverseCellSize)
+	{
+		return glm::ivec3{ std::floor(position.x * inverseCellSize), std::floor(position.y * inverseCellSize), std::floor(position.z * inverseCellSize) };
+	}
+
+	static std::uint64_t GetCellKey(const glm::ivec3& cell)
+	{
+		return (static_cast<std::uint64_t>(cell.x & 0x1FFFFF) << 42) | (static_cast<std::uint64_t>(cell.y & 0x1FFFFF) << 21) | static_cast<std::uint64_t>(cell.z & 0x1FFFFF);
+	}
+
+	static std::uint32_t GetBucket(std::uint64_t key, std::uint32_t mask)
+	{
+		key ^= key >> 33;
+		key *= 0xFF51AFD7ED558CCDull;
+		key ^= key >> 33;
+
+		return static_cast<std::uint32_t>(key) & mask;
+	}
+
+	// Counting sort by hashed cell, so entries of one cell end up contiguous without a full comparison sort.
+	void SortEntries()
+	{
+		std::uint32_t bucketCount = 1;
+
+		while (bucketCount < entries.size() * 2)
+			bucketCount <<= 1;
+
+		std::uint32_t mask = bucketCount - 1;
+
+		bucketStarts.assign(bucketCount + 1, 0);
+
+		for (const CellEntry& entry : entries)
+			bucketStarts[GetBucket(entry.key, mask) + 1]++;
+
+		for (std::uint32_t b = 0; b < bucketCount; ++b)
+			bucketStarts[b + 1] += bucketStarts[b];
+
+		cursors.assign(bucketStarts.begin(), bucketStarts.end() - 1);
+		sortedEntries.resize(entries.size());
+
+		for (const CellEntry& entry : entries)
+			sortedEntries[cursors[GetBucket(entry.key, mask)]++] = entry;
+	}
+
+	std::vector<CellEntry> entries;
+	std::vector<CellEntry> sortedEntries;
+	std::vector<std::uint32_t> bucketStarts;
+	std::vector<std::uint32_t> cursors;
+};
+
+#endif // !SPATIAL_HASH_GRID_HPP
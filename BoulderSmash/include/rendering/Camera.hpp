@@ -5,10 +5,12 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include "core/Input.hpp"
+#include "core/Time.hpp"
 #include "core/Window.hpp"
 #include "components/BoxCollider.hpp"
 #include "components/Transform.hpp"
 #include "gameplay/Entity.hpp"
+#include "physics/PhysicsWorld.hpp"
 
 struct CameraProjection
 {
@@ -41,29 +43,23 @@ public:
 
 	void Update()
 	{
-		static bool isColliding = true;
-
-		float currentFrame = static_cast<float>(glfwGetTime());
-		deltaTime = currentFrame - lastFrame;
-		lastFrame = currentFrame;
-
 		view = glm::lookAt(transform.position, transform.position + qtov(transform.rotation), transform.up);
 		
 		if (true) //TODO: Make this update every time the window resizes!
 			projection = glm::perspective<float>(glm::radians(45.0f), static_cast<float>((float)Window::size.x / (float)Window::size.y), 0.01, 100);
 		
-		if (collider.IsCollidingWith(EntityManager::GetEntity("asteroid").gameObject->GetComponent<BoxCollider>()) && isColliding)
+		for (const CollisionEvent& event : PhysicsWorld::GetCollisionEvents())
 		{
-			SoundManager::PlayEffect("explosion", false);
-
-			isColliding = false;
+			if (event.type == CollisionEventType::ENTER && event.Involves(entity))
+				SoundManager::PlayEffect("explosion", false);
 		}
-			
-		if (!collider.IsCollidingWith(EntityManager::GetEntity("asteroid").gameObject->GetComponent<BoxCollider>()) && !isColliding)
-			isColliding = true;
 
 		UpdateInput();
-		collider.transformThis = transform;
+
+		GameObject* gameObject = ECSManager::GetGameObject(entity);
+
+		if (gameObject)
+			gameObject->transform.position = transform.position;
 	}
 
 	CameraProjection GetProjection() const
@@ -74,7 +70,7 @@ public:
 		return out;
 	}
 
-	BoxCollider collider;
+	EntityID entity = nullEntity;
 	Transform transform;
 
 private:
@@ -83,7 +79,10 @@ private:
 	{
 		Logger_WriteConsole("Attempting to intialize internal stuff...", LogLevel::INFO);
 
-		collider = BoxCollider::Register(transform, glm::vec3{ 1.2, 1.2, 1.2 }, false);
+		GameObject& gameObject = ECSManager::AddGameObject();
+
+		gameObject.AddComponent<BoxCollider>(BoxCollider::Register(TRANSFORM_DEFAULT, glm::vec3{ 1.2, 1.2, 1.2 }, true));
+		entity = gameObject.GetID();
 
 		Logger_WriteConsole("Successfully intialized internal stuff!", LogLevel::INFO);
 	}
@@ -92,7 +91,7 @@ private:
 	{
 		if (!isPaused)
 		{
-			float cameraSpeed = static_cast<float>(2.5 * deltaTime);
+			float cameraSpeed = 2.5f * Time::deltaTime;
 			if (Input::GetKeyDown(GLFW_KEY_W))
 			{
 				//Logger_WriteConsole(std::format("Position: [{}, {}, {}]", transform.position.x, transform.position.y, transform.position.z), LogLevel::INFO);
@@ -174,9 +173,6 @@ private:
 	float lastY = 600.0 / 2.0;
 	float fov = 45.0f;
 
-	float deltaTime = 0.0f;
-	float lastFrame = 0.0f;
-
 	bool isPaused;
 
 	glm::mat4 view = glm::mat4(1.0f);
@@ -0,0 +1,155 @@
+#ifndef FRAME_UNIFORMS_HPP
+#define FRAME_UNIFORMS_HPP
+
+#include <memory>
+#include <vector>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include "lighting/DirectionalLight.hpp"
+#include "lighting/PointLight.hpp"
+#include "rendering/Camera.hpp"
+#include "rendering/GLState.hpp"
+#include "rendering/ShaderManager.hpp"
+
+#define maxPointLights 4
+
+// The structs below mirror the std140 blocks declared in the shaders: a vec3 fills a whole 16 byte slot unless a float follows it.
+struct CameraBlock
+{
+	glm::mat4 projection;
+	glm::mat4 view;
+	glm::vec3 viewPosition;
+	float padding;
+};
+
+struct DirectionalLightBlock
+{
+	glm::vec3 direction;
+	float padding0;
+	glm::vec3 ambient;
+	float padding1;
+	glm::vec3 diffuse;
+	float padding2;
+	glm::vec3 specular;
+	float padding3;
+};
+
+struct PointLightBlock
+{
+	glm::vec3 position;
+	float constant;
+	float linear;
+	float quadratic;
+	float padding0[2];
+	glm::vec3 ambient;
+	float padding1;
+	glm::vec3 diffuse;
+	float padding2;
+	glm::vec3 specular;
+	float padding3;
+};
+
+struct SpotLightBlock
+{
+	glm::vec3 position;
+	float padding0;
+	glm::vec3 direction;
+	float cutOff;
+	float outerCutOff;
+	float constant;
+	float linear;
+	float quadratic;
+	glm::vec3 ambient;
+	float padding1;
+	glm::vec3 diffuse;
+	float padding2;
+	glm::vec3 specular;
+	float padding3;
+};
+
+struct LightsBlock
+{
+	DirectionalLightBlock directionalLight;
+	PointLightBlock pointLights[maxPointLights];
+	SpotLightBlock spotLight;
+};
+
+static_assert(sizeof(CameraBlock) == 144 && sizeof(PointLightBlock) == 80 && sizeof(SpotLightBlock) == 96 && sizeof(LightsBlock) == 480, "Uniform blocks must match their std140 layout");
+
+// Camera and light data shared by every program through fixed binding points, written once per frame instead of once per object.
+namespace FrameUniforms
+{
+	extern unsigned int cameraBuffer;
+	extern unsigned int lightsBuffer;
+
+	// Re-specifying the whole store orphans last frame's copy, so the upload never waits on draws still reading it.
+	void Upload(unsigned int& buffer, unsigned int binding, const void* data, std::size_t size)
+	{
+		bool created = buffer == 0;
+
+		if (created)
+			glGenBuffers(1, &buffer);
+
+		GLState::BindBuffer(GL_UNIFORM_BUFFER, buffer);
+		glBufferData(GL_UNIFORM_BUFFER, size, data, GL_STREAM_DRAW);
+
+		if (created)
+			GLState::BindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+	}
+
+	// Point lights past maxPointLights are dropped; unused slots stay zeroed, which the shaders skip.
+	void Update(std::shared_ptr<Camera>& camera, const std::shared_ptr<DirectionalLight>& directionalLight, const std::vector<std::shared_ptr<PointLight>>& lights)
+	{
+		CameraBlock cameraBlock{};
+
+		cameraBlock.projection = camera->GetProjection().projection;
+		cameraBlock.view = camera->GetProjection().view;
+		cameraBlock.viewPosition = camera->transform.position;
+
+		Upload(cameraBuffer, cameraBlockBinding, &cameraBlock, sizeof(cameraBlock));
+
+		LightsBlock lightsBlock{};
+
+		if (directionalLight)
+		{
+			lightsBlock.directionalLight.direction = directionalLight->direction;
+			lightsBlock.directionalLight.ambient = directionalLight->ambient;
+			lightsBlock.directionalLight.diffuse = directionalLight->diffuse;
+			lightsBlock.directionalLight.specular = directionalLight->specular;
+		}
+
+		for (std::size_t l = 0; l < lights.size() && l < maxPointLights; ++l)
+		{
+			PointLightBlock& pointLight = lightsBlock.pointLights[l];
+
+			pointLight.position = lights[l]->transform.position;
+			pointLight.constant = 1.0f;
+			pointLight.linear = 0.09f;
+			pointLight.quadratic = 0.032f;
+			pointLight.ambient = lights[l]->ambient;
+			pointLight.diffuse = lights[l]->diffuse;
+			pointLight.specular = lights[l]->specular;
+		}
+
+		SpotLightBlock& spotLight = lightsBlock.spotLight;
+
+		spotLight.position = camera->transform.position;
+		spotLight.direction = qtov(camera->transform.rotation);
+		spotLight.cutOff = glm::cos(glm::radians(12.5f));
+		spotLight.outerCutOff = glm::cos(glm::radians(17.0f));
+		spotLight.constant = 1.0f;
+		spotLight.linear = 0.09f;
+		spotLight.quadratic = 0.032f;
+		spotLight.ambient = glm::vec3{ 0.0f, 0.0f, 0.0f };
+		spotLight.diffuse = glm::vec3{ 0.0f, 0.0f, 0.0f };
+		spotLight.specular = glm::vec3{ 1.0f, 1.0f, 1.0f };
+
+		Upload(lightsBuffer, lightsBlockBinding, &lightsBlock, sizeof(lightsBlock));
+	}
+}
+
+unsigned int FrameUniforms::cameraBuffer = 0;
+unsigned int FrameUniforms::lightsBuffer = 0;
+
+#endif // !FRAME_UNIFORMS_HPP
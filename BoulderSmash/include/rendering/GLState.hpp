@@ -0,0 +1,290 @@
+#ifndef GL_STATE_HPP
+#define GL_STATE_HPP
+
+#include <array>
+#include <cstddef>
+#include <glad/glad.h>
+
+#define maxTrackedTextureUnits 32
+#define unknownBinding 0xFFFFFFFFu
+
+struct GLStateCounters
+{
+	std::size_t issued = 0;
+	std::size_t filtered = 0;
+};
+
+// Shadows the GL state the frame changes most and drops calls that would set what is already set. The shadow is only trusted
+// between BeginFrame calls: GL calls made outside this layer (asset loading, buffer setup) must happen before BeginFrame.
+// Element array bindings belong to the bound VAO, so they are not tracked here.
+namespace GLState
+{
+	extern unsigned int program;
+	extern unsigned int vertexArray;
+	extern unsigned int arrayBuffer;
+	extern unsigned int uniformBuffer;
+	extern unsigned int activeTexture;
+	// 2D and cube map binding per unit.
+	extern std::array<std::array<unsigned int, 2>, maxTrackedTextureUnits> textures;
+
+	// Enabled state of GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE and GL_STENCIL_TEST: -1 unknown, 0 disabled, 1 enabled.
+	extern int capabilities[4];
+
+	extern GLenum depthFunc;
+	extern int depthMask;
+	extern GLenum blendSource;
+	extern GLenum blendDestination;
+
+	extern GLStateCounters counters;
+	extern GLStateCounters lastFrameCounters;
+
+	// Forgets everything, so the next call of each kind is issued.
+	void Invalidate()
+	{
+		program = unknownBinding;
+		vertexArray = unknownBinding;
+		arrayBuffer = unknownBinding;
+		uniformBuffer = unknownBinding;
+		activeTexture = unknownBinding;
+
+		for (auto& unit : textures)
+			unit[0] = unit[1] = unknownBinding;
+
+		for (int& capability : capabilities)
+			capability = -1;
+
+		depthFunc = unknownBinding;
+		depthMask = -1;
+		blendSource = unknownBinding;
+		blendDestination = unknownBinding;
+	}
+
+	// Call right before the frame's rendering starts; the counters of the frame before are kept for GetLastFrameCounters.
+	void BeginFrame()
+	{
+		lastFrameCounters = counters;
+		counters = {};
+
+		Invalidate();
+	}
+
+	const GLStateCounters& GetLastFrameCounters()
+	{
+		return lastFrameCounters;
+	}
+
+	bool Track(unsigned int& shadow, unsigned int value)
+	{
+		if (shadow == value)
+		{
+			counters.filtered++;
+			return false;
+		}
+
+		shadow = value;
+		counters.issued++;
+
+		return true;
+	}
+
+	// Each setter returns whether the call reached GL.
+	bool UseProgram(unsigned int id)
+	{
+		if (!Track(program, id))
+			return false;
+
+		glUseProgram(id);
+		return true;
+	}
+
+	bool BindVertexArray(unsigned int id)
+	{
+		if (!Track(vertexArray, id))
+			return false;
+
+		glBindVertexArray(id);
+		return true;
+	}
+
+	bool BindBuffer(GLenum target, unsigned int id)
+	{
+		unsigned int* shadow = target == GL_ARRAY_BUFFER ? &arrayBuffer : target == GL_UNIFORM_BUFFER ? &uniformBuffer : nullptr;
+
+		if (shadow && !Track(*shadow, id))
+			return false;
+
+		if (!shadow)
+			counters.issued++;
+
+		glBindBuffer(target, id);
+		return true;
+	}
+
+	// Also replaces the generic binding of target, as glBindBufferBase does.
+	void BindBufferBase(GLenum target, unsigned int index, unsigned int id)
+	{
+		if (target == GL_UNIFORM_BUFFER)
+			uniformBuffer = id;
+
+		counters.issued++;
+
+		glBindBufferBase(target, index, id);
+	}
+
+	// Deleting a bound buffer unbinds it, and GL may hand the name out again, so the shadow has to forget it too.
+	void DeleteBuffer(unsigned int& id)
+	{
+		if (arrayBuffer == id)
+			arrayBuffer = 0;
+
+		if (uniformBuffer == id)
+			uniformBuffer = 0;
+
+		glDeleteBuffers(1, &id);
+		id = 0;
+	}
+
+	bool ActiveTexture(unsigned int unit)
+	{
+		if (!Track(activeTexture, unit))
+			return false;
+
+		glActiveTexture(GL_TEXTURE0 + unit);
+		return true;
+	}
+
+	// Binds on the given unit, switching the active unit only when the binding actually changes.
+	bool BindTexture(unsigned int unit, GLenum target, unsigned int id)
+	{
+		int slot = target == GL_TEXTURE_2D ? 0 : target == GL_TEXTURE_CUBE_MAP ? 1 : -1;
+
+		if (unit >= maxTrackedTextureUnits || slot == -1)
+		{
+			ActiveTexture(unit);
+
+			counters.issued++;
+			glBindTexture(target, id);
+
+			return true;
+		}
+
+		if (!Track(textures[unit][slot], id))
+			return false;
+
+		ActiveTexture(unit);
+		glBindTexture(target, id);
+
+		return true;
+	}
+
+	int GetCapabilityIndex(GLenum capability)
+	{
+		switch (capability)
+		{
+
+		case GL_BLEND:
+			return 0;
+
+		case GL_DEPTH_TEST:
+			return 1;
+
+		case GL_CULL_FACE:
+			return 2;
+
+		case GL_STENCIL_TEST:
+			return 3;
+
+		default:
+			return -1;
+
+		}
+	}
+
+	bool SetCapability(GLenum capability, bool enabled)
+	{
+		int index = GetCapabilityIndex(capability);
+
+		if (index != -1 && capabilities[index] == static_cast<int>(enabled))
+		{
+			counters.filtered++;
+			return false;
+		}
+
+		if (index != -1)
+			capabilities[index] = static_cast<int>(enabled);
+
+		counters.issued++;
+
+		if (enabled)
+			glEnable(capability);
+		else
+			glDisable(capability);
+
+		return true;
+	}
+
+	bool DepthFunc(GLenum function)
+	{
+		if (!Track(depthFunc, function))
+			return false;
+
+		glDepthFunc(function);
+		return true;
+	}
+
+	bool DepthMask(bool enabled)
+	{
+		if (depthMask == static_cast<int>(enabled))
+		{
+			counters.filtered++;
+			return false;
+		}
+
+		depthMask = static_cast<int>(enabled);
+		counters.issued++;
+
+		glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+		return true;
+	}
+
+	bool BlendFunc(GLenum source, GLenum destination)
+	{
+		if (blendSource == source && blendDestination == destination)
+		{
+			counters.filtered++;
+			return false;
+		}
+
+		blendSource = source;
+		blendDestination = destination;
+		counters.issued++;
+
+		glBlendFunc(source, destination);
+		return true;
+	}
+}
+
+unsigned int GLState::program = unknownBinding;
+unsigned int GLState::vertexArray = unknownBinding;
+unsigned int GLState::arrayBuffer = unknownBinding;
+unsigned int GLState::uniformBuffer = unknownBinding;
+unsigned int GLState::activeTexture = unknownBinding;
+// Starts unknown like every other shadow: a zero would filter the first unbind of each unit before anything reached GL.
+std::array<std::array<unsigned int, 2>, maxTrackedTextureUnits> GLState::textures = []()
+{
+	std::array<std::array<unsigned int, 2>, maxTrackedTextureUnits> unknown;
+
+	for (auto& unit : unknown)
+		unit.fill(unknownBinding);
+
+	return unknown;
+}();
+int GLState::capabilities[4] = { -1, -1, -1, -1 };
+GLenum GLState::depthFunc = unknownBinding;
+int GLState::depthMask = -1;
+GLenum GLState::blendSource = unknownBinding;
+GLenum GLState::blendDestination = unknownBinding;
+GLStateCounters GLState::counters;
+GLStateCounters GLState::lastFrameCounters;
+
+#endif // !GL_STATE_HPP
@@ -0,0 +1,250 @@
+#ifndef MODEL_ASSET_HPP
+#define MODEL_ASSET_HPP
+
+#include <memory>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <string>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#include "core/Logger.hpp"
+#include "rendering/Renderer.hpp"
+#include "rendering/Texture.hpp"
+
+#define MAX_BONE_INFLUENCE 4
+
+struct Vertex
+{
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoords;
+    glm::vec3 tangent;
+    glm::vec3 bitangent;
+
+    int boneIDs[MAX_BONE_INFLUENCE];
+    float weights[MAX_BONE_INFLUENCE];
+};
+
+// One imported model file: its meshes already uploaded to the GPU and its textures, shared by every Model built from the same path.
+struct ModelAsset
+{
+    bool Import(const std::string& path)
+    {
+        Logger_WriteConsole("Attempting to import a Model asset...", LogLevel::INFO);
+
+        this->path = path;
+
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+
+        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) // if is Not Zero
+        {
+            Logger_WriteConsole(importer.GetErrorString(), LogLevel::ISSUE);
+            return false;
+        }
+
+        directory = path.substr(0, path.find_last_of('/'));
+
+        ProcessNode(scene->mRootNode, scene);
+
+        Logger_WriteConsole("Successfully imported a Model asset!", LogLevel::INFO);
+        return true;
+    }
+
+    void Release()
+    {
+        for (auto& mesh : meshes)
+        {
+            glDeleteVertexArrays(1, &mesh.VAO);
+            glDeleteBuffers(1, &mesh.VBO);
+            glDeleteBuffers(1, &mesh.EBO);
+        }
+
+        for (auto& texture : texturesLoaded)
+            glDeleteTextures(1, &texture.data.ID);
+
+        meshes.clear();
+        texturesLoaded.clear();
+    }
+
+    std::string path;
+    std::string directory;
+
+    std::vector<Texture> texturesLoaded;
+    std::vector<RenderableObject> meshes;
+
+private:
+
+    void ProcessNode(aiNode* node, const aiScene* scene)
+    {
+        for (unsigned int i = 0; i < node->mNumMeshes; i++)
+        {
+            aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
+            ProcessMesh(mesh, scene);
+        }
+
+        for (unsigned int i = 0; i < node->mNumChildren; i++)
+        {
+            ProcessNode(node->mChildren[i], scene);
+        }
+    }
+
+    void ProcessMesh(aiMesh* mesh, const aiScene* scene)
+    {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+
+        for (unsigned int i = 0; i < mesh->mNumVertices; i++)
+        {
+            Vertex vertex;
+
+            vertex.position = glm::vec3{mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z};
+
+            if (mesh->HasNormals())
+                vertex.normal = glm::vec3{mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z};
+
+            if (mesh->mTextureCoords[0])
+            {
+                vertex.texCoords = glm::vec2{mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y};
+
+                vertex.tangent = glm::vec3{mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z};
+
+                vertex.bitangent = glm::vec3{mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z};
+            }
+            else
+                vertex.texCoords = glm::vec2(0.0f, 0.0f);
+
+            vertices.push_back(vertex);
+        }
+
+        for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+        {
+            aiFace face = mesh->mFaces[i];
+
+            for (unsigned int j = 0; j < face.mNumIndices; j++)
+                indices.push_back(face.mIndices[j]);
+        }
+
+        aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+
+        RenderableObject object;
+
+        LoadMaterialTextures(object, material, aiTextureType_DIFFUSE, "texture_diffuse");
+        LoadMaterialTextures(object, material, aiTextureType_SPECULAR, "texture_specular");
+        LoadMaterialTextures(object, material, aiTextureType_HEIGHT, "texture_normal");
+        LoadMaterialTextures(object, material, aiTextureType_AMBIENT, "texture_height");
+
+        object.RegisterValues(true, true, path, glm::vec3{ 0.0f }, {}, indices);
+
+        object.RequestGLBufferCall(GLBufferCall::Register(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW, "VBO", "verticesCall"));
+        object.RequestGLBufferCall(GLBufferCall::Register(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW, "EBO", "indicesCall"));
+
+        object.RequestGLPointerCall(GLPointerCall::Register(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0, 0, "firstCall", GLPointerType::D));
+        object.RequestGLPointerCall(GLPointerCall::Register(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal), 1, "normalCall", GLPointerType::D));
+        object.RequestGLPointerCall(GLPointerCall::Register(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords), 2, "texCoordsCall", GLPointerType::D));
+        object.RequestGLPointerCall(GLPointerCall::Register(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent), 3, "tangentCall", GLPointerType::D));
+        object.RequestGLPointerCall(GLPointerCall::Register(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, bitangent), 4, "bitangentCall", GLPointerType::D));
+        object.RequestGLPointerCall(GLPointerCall::Register(5, 4, GL_INT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, boneIDs), 5, "boneIDsCall", GLPointerType::I));
+        object.RequestGLPointerCall(GLPointerCall::Register(6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, weights), 6, "weightsCall", GLPointerType::D));
+
+        object.GenerateRawObject();
+
+        // The indices only live on the GPU from here on, so copies handed to the Renderer stay small.
+        object.data.indices.clear();
+        object.data.indices.shrink_to_fit();
+
+        meshes.push_back(object);
+    }
+
+    void LoadMaterialTextures(RenderableObject& object, aiMaterial* mat, aiTextureType type, const std::string& typeName)
+    {
+        for (unsigned int i = 0; i < mat->GetTextureCount(type); i++)
+        {
+            aiString str;
+            mat->GetTexture(type, i, &str);
+
+            bool skip = false;
+            for (unsigned int j = 0; j < texturesLoaded.size(); j++)
+            {
+                if (std::strcmp(texturesLoaded[j].data.path.c_str(), str.C_Str()) == 0)
+                {
+                    Texture texture = texturesLoaded[j];
+
+                    texture.data.type = typeName;
+
+                    object.RegisterTexture(texture);
+                    skip = true;
+                    break;
+                }
+            }
+            if (!skip)
+            {
+                Texture texture = Texture::LoadTextureStatic(std::string(str.C_Str()), TextureProperties::Register(GL_REPEAT, GL_LINEAR, false));
+
+                texture.data.path = str.C_Str();
+                texture.data.type = typeName;
+
+                object.RegisterTexture(texture);
+                texturesLoaded.push_back(texture);
+            }
+        }
+    }
+};
+
+using ModelHandle = std::shared_ptr<ModelAsset>;
+
+// Imports each model file once; Models and their renderer copies hold the asset and Collect frees it once none are left.
+namespace ModelAssetManager
+{
+    extern std::unordered_map<std::string, ModelHandle> assets;
+
+    // Returns nullptr when the file cannot be imported.
+    ModelHandle Load(const std::string& path)
+    {
+        auto found = assets.find(path);
+
+        if (found != assets.end())
+            return found->second;
+
+        ModelHandle asset = std::make_shared<ModelAsset>();
+
+        if (!asset->Import(path))
+            return nullptr;
+
+        assets.emplace(path, asset);
+
+        return asset;
+    }
+
+    // Models and registered renderer copies still using the asset; 0 for paths that are not loaded.
+    std::size_t GetReferenceCount(const std::string& path)
+    {
+        auto found = assets.find(path);
+
+        return found != assets.end() ? found->second.use_count() - 1 : 0;
+    }
+
+    // Frees the GPU objects of assets nothing refers to anymore; call on the main thread after rendering so no draw still uses them.
+    void Collect()
+    {
+        for (auto asset = assets.begin(); asset != assets.end();)
+        {
+            if (asset->second.use_count() > 1)
+            {
+                ++asset;
+                continue;
+            }
+
+            asset->second->Release();
+            asset = assets.erase(asset);
+        }
+    }
+}
+
+std::unordered_map<std::string, ModelHandle> ModelAssetManager::assets;
+
+#endif // !MODEL_ASSET_HPP
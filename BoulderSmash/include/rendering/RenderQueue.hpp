@@ -0,0 +1,104 @@
+#ifndef RENDER_QUEUE_HPP
+#define RENDER_QUEUE_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+#define opaquePass 0
+#define transparentPass 1
+
+struct DrawItem
+{
+	std::uint64_t key;
+	std::uint32_t index;
+	bool instanced;
+};
+
+// One frame's draws, ordered by a packed key so neighbouring draws share as much GL state as possible.
+// Opaque keys are pass(2) | program(12) | material(16) | VAO(16) | depth(18), nearest first within equal state;
+// transparent keys are pass(2) | inverted depth(18) | program(12) | material(16) | VAO(16), so they draw farthest first.
+class RenderQueue
+{
+
+public:
+
+	void Clear()
+	{
+		items.clear();
+	}
+
+	void Push(std::uint64_t key, std::uint32_t index, bool instanced)
+	{
+		items.push_back({ key, index, instanced });
+	}
+
+	// Stable LSD radix sort over 8 bit digits; digits every key shares are skipped, which is most of them in a typical frame.
+	void Sort()
+	{
+		scratch.resize(items.size());
+
+		for (int shift = 0; shift < 64; shift += 8)
+		{
+			std::size_t offsets[256] = {};
+
+			for (const DrawItem& item : items)
+				offsets[(item.key >> shift) & 0xFF]++;
+
+			if (items.empty() || offsets[(items[0].key >> shift) & 0xFF] == items.size())
+				continue;
+
+			std::size_t total = 0;
+
+			for (std::size_t& offset : offsets)
+			{
+				std::size_t count = offset;
+
+				offset = total;
+				total += count;
+			}
+
+			for (const DrawItem& item : items)
+				scratch[offsets[(item.key >> shift) & 0xFF]++] = item;
+
+			items.swap(scratch);
+		}
+	}
+
+	const std::vector<DrawItem>& GetItems() const
+	{
+		return items;
+	}
+
+	// Key fields are truncated to their width; a collision only costs a state change, since submission compares the real state.
+	static std::uint64_t MakeKey(int pass, unsigned int program, unsigned int material, unsigned int vertexArray, float depth)
+	{
+		std::uint64_t depthBits = static_cast<std::uint64_t>(glm::clamp(depth / depthRange, 0.0f, 1.0f) * maxDepth);
+		std::uint64_t state = (static_cast<std::uint64_t>(program & 0xFFF) << 32) | (static_cast<std::uint64_t>(material & 0xFFFF) << 16) | (vertexArray & 0xFFFF);
+
+		if (pass == opaquePass)
+			return (state << 18) | depthBits;
+
+		return (static_cast<std::uint64_t>(pass) << 62) | ((maxDepth - depthBits) << 44) | state;
+	}
+
+	static int GetPass(std::uint64_t key)
+	{
+		return static_cast<int>(key >> 62);
+	}
+
+	// View distance mapped onto the depth bits; anything further sorts as if it were at this distance.
+	static float depthRange;
+
+private:
+
+	static constexpr std::uint64_t maxDepth = 0x3FFFF;
+
+	std::vector<DrawItem> items;
+	std::vector<DrawItem> scratch;
+};
+
+float RenderQueue::depthRange = 1024.0f;
+
+#endif // !RENDER_QUEUE_HPP
@@ -1,7 +1,11 @@
 #ifndef RENDERER_HPP
 #define RENDERER_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 #include <string>
@@ -11,13 +15,20 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include "core/Logger.hpp"
+#include "core/TransformHierarchy.hpp"
 #include "components/Transform.hpp"
 #include "lighting/DirectionalLight.hpp"
 #include "lighting/PointLight.hpp"
 #include "rendering/Camera.hpp"
+#include "rendering/FrameUniforms.hpp"
+#include "rendering/GLState.hpp"
+#include "rendering/RenderQueue.hpp"
 #include "rendering/ShaderManager.hpp"
 #include "rendering/Texture.hpp"
 
+#define instanceAttributeLocation 7
+#define maxTexturesPerType 4
+
 enum class GLPointerType
 {
 	D,
@@ -92,15 +103,24 @@ struct RenderableData
 	TextureProperties texturePorperties;
 	ShaderObject shader;
 	Transform transform;
+	glm::vec4 tint = glm::vec4{ 1.0f };
 	bool doDefaultLighting;
+
+	// Drawn after the skybox, farthest first, without depth writes; only honoured for programs that are not instanced.
+	bool transparent = false;
 	bool completelyReplaceDefaultGLPointerCalls;
 };
 
 struct RenderableObject
 {
 	RenderableData data;
+	EntityID owner = nullEntity;
+
+	// Keeps a shared ModelAsset's buffers alive while this copy is registered; empty for objects that own their buffers.
+	std::shared_ptr<void> asset;
 
 	unsigned int VBO, VAO, EBO;
+	unsigned int indexCount = 0;
 
 	void GenerateTestObject(const std::string& name, const glm::vec3& position)
 	{
@@ -311,6 +331,7 @@ struct RenderableObject
 
 		data.shader = ShaderManager::GetShader(shaderName);
 		data.shader.BindShader();
+		data.transparent = shaderName == "transparentShader";
 
 		for (int v = 0; v < verticesSize; ++v)
 		{
@@ -332,6 +353,7 @@ struct RenderableObject
 
 		data.shader = ShaderManager::GetShader(shaderName);
 		data.shader.BindShader();
+		data.transparent = shaderName == "transparentShader";
 
 		this->data.vertices = vertices;
 		this->data.indices = indices;
@@ -349,6 +371,53 @@ struct RenderableObject
 		PostGLPointerCalls();
 
 		glBindVertexArray(0);
+
+		indexCount = static_cast<unsigned int>(data.indices.size());
+	}
+};
+
+// Per-instance vertex attributes read by instanced shaders, starting at instanceAttributeLocation: model (4 slots), normal (3), tint (1).
+struct InstanceData
+{
+	glm::mat4 model;
+	glm::mat3 normal;
+	glm::vec4 tint;
+};
+
+// Every registered object sharing one VAO and program, drawn with a single glDrawElementsInstanced call.
+struct InstanceBatch
+{
+	unsigned int buffer = 0;
+	std::size_t capacity = 0;
+
+	RenderableObject* first = nullptr;
+	std::vector<InstanceData> instances;
+};
+
+// Handles for the per-object uniforms RenderObjects sets, resolved once per program so the frame never builds a uniform name.
+struct ObjectUniforms
+{
+	UniformHandle model, shininess;
+
+	// Indexed by texture type (diffuse, specular, normal, height), then by the number suffixed to the sampler name minus one.
+	UniformHandle textures[4][maxTexturesPerType];
+
+	static ObjectUniforms Register(const ShaderObject& shader)
+	{
+		ObjectUniforms out;
+
+		out.model = shader.GetUniform("model");
+		out.shininess = shader.GetUniform("material.shininess");
+
+		const char* textureTypes[4] = { "texture_diffuse", "texture_specular", "texture_normal", "texture_height" };
+
+		for (int t = 0; t < 4; ++t)
+		{
+			for (int n = 0; n < maxTexturesPerType; ++n)
+				out.textures[t][n] = shader.GetUniform(textureTypes[t] + std::to_string(n + 1));
+		}
+
+		return out;
 	}
 };
 
@@ -378,6 +447,12 @@ namespace Renderer
 	extern std::vector<std::shared_ptr<PointLight>> lights;
 	extern std::deque<ShaderCall> shaderCalls;
 	extern std::shared_ptr<DirectionalLight> directionalLight;
+	extern std::unordered_map<std::uint64_t, InstanceBatch> instanceBatches;
+	extern std::unordered_map<unsigned int, unsigned int> instanceAttributeBuffers;
+	extern std::unordered_map<unsigned int, ObjectUniforms> objectUniforms;
+	extern RenderQueue renderQueue;
+	extern std::vector<InstanceBatch*> queuedBatches;
+	extern std::size_t transparentBegin;
 
 	void RegisterRenderableObject(const RenderableObject& object)
 	{
@@ -487,93 +562,265 @@ namespace Renderer
 		}
 	}
 
-	void RenderObjects(std::shared_ptr<Camera>& camera)
+	// Objects whose owning GameObject was destroyed are dropped, releasing their hold on any shared asset.
+	void RemoveOrphanedObjects()
 	{
-		for (auto& object : registeredObjects)
+		registeredObjects.erase(std::remove_if(registeredObjects.begin(), registeredObjects.end(), [](const RenderableObject& object)
+		{
+			return object.owner != nullEntity && !ECSManager::IsValid(object.owner);
+		}), registeredObjects.end());
+	}
+
+	ObjectUniforms& GetObjectUniforms(const ShaderObject& shader)
+	{
+		auto found = objectUniforms.find(shader.ID);
+
+		if (found != objectUniforms.end())
+			return found->second;
+
+		return objectUniforms.emplace(shader.ID, ObjectUniforms::Register(shader)).first->second;
+	}
+
+	int GetTextureType(const std::string& type)
+	{
+		if (type == "texture_diffuse")
+			return 0;
+		else if (type == "texture_specular")
+			return 1;
+		else if (type == "texture_normal")
+			return 2;
+		else if (type == "texture_height")
+			return 3;
+
+		return -1;
+	}
+
+	// Binds the object's program, textures and VAO and sets its material, skipping whatever the previous draw already left bound.
+	// Camera and lights come from the FrameUniforms blocks, and the model matrix is left to the caller.
+	void ApplyObjectState(RenderableObject& object)
+	{
+		ShaderObject& shader = object.data.shader;
+		ObjectUniforms& uniforms = GetObjectUniforms(shader);
+
+		bool programChanged = shader.Use();
+
+		if (programChanged && object.data.doDefaultLighting)
+			shader.SetFloat(uniforms.shininess, 32.0f);
+
+		bool texturesChanged = programChanged;
+
+		for (unsigned int t = 0; t < object.data.textures.size(); t++)
+			texturesChanged |= GLState::BindTexture(t, GL_TEXTURE_2D, object.data.textures[t].data.ID);
+
+		// Which unit each sampler reads depends on the texture types, so samplers are only reassigned when the set changes.
+		if (texturesChanged)
 		{
-			unsigned int diffuseNr = 1;
-			unsigned int specularNr = 1;
-			unsigned int normalNr = 1;
-			unsigned int heightNr = 1;
+			int textureNumbers[4] = { 0, 0, 0, 0 };
 
 			for (unsigned int t = 0; t < object.data.textures.size(); t++)
 			{
-				glActiveTexture(GL_TEXTURE0 + t);
-
-				std::string number;
-				std::string name = object.data.textures[t].data.type;
-				if (name == "texture_diffuse")
-					number = std::to_string(diffuseNr++);
-				else if (name == "texture_specular")
-					number = std::to_string(specularNr++);
-				else if (name == "texture_normal")
-					number = std::to_string(normalNr++);
-				else if (name == "texture_height")
-					number = std::to_string(heightNr++);
-
-				glUniform1i(glGetUniformLocation(object.data.shader.ID, (name + number).c_str()), t);
-				glBindTexture(GL_TEXTURE_2D, object.data.textures[t].data.ID);
+				int type = GetTextureType(object.data.textures[t].data.type);
+
+				if (type != -1 && textureNumbers[type] < maxTexturesPerType)
+					glUniform1i(uniforms.textures[type][textureNumbers[type]++].location, t);
 			}
-		
-			glm::mat4 transform = glm::mat4(1.0f);
-			transform = glm::translate(transform, object.data.transform.position);
+		}
 
-			if(object.data.transform.rotation.x > 0 || object.data.transform.rotation.y > 0 || object.data.transform.rotation.z > 0)
-				transform = glm::rotate(transform, object.data.transform.rotation.w, qtov(object.data.transform.rotation));
+		GLState::BindVertexArray(object.VAO);
 
-			/*if (object.data.transform.rotation.x <= 0)
-				object.data.transform.rotation.x = 0.001f;
+		PostShaderCalls();
+	}
 
-			if (object.data.transform.rotation.y <= 0)
-				object.data.transform.rotation.y = 0.001f;
+	unsigned int GetMaterial(const RenderableObject& object)
+	{
+		return object.data.textures.empty() ? 0 : object.data.textures[0].data.ID;
+	}
 
-			if (object.data.transform.rotation.z <= 0)
-				object.data.transform.rotation.z = 0.001f;*/
-			
+	InstanceData GetInstance(const RenderableObject& object)
+	{
+		GameObject* owner = ECSManager::GetGameObject(object.owner);
+
+		if (owner && TransformHierarchy::HasWorldMatrix(*owner))
+			return { TransformHierarchy::GetWorldMatrix(*owner), TransformHierarchy::GetNormalMatrix(*owner), object.data.tint };
+
+		glm::mat4 model = object.data.transform.ToMatrix();
+
+		return { model, glm::transpose(glm::inverse(glm::mat3(model))), object.data.tint };
+	}
+
+	// Each VAO and program pair gets its own instance buffer; programs sharing a mesh share its VAO, so the attributes are pointed
+	// at the right buffer when the batch is drawn.
+	InstanceBatch& GetInstanceBatch(const RenderableObject& object)
+	{
+		std::uint64_t key = (static_cast<std::uint64_t>(object.VAO) << 32) | object.data.shader.ID;
+
+		auto found = instanceBatches.find(key);
 
-			object.data.shader.Use();
-			object.data.shader.SetMat4("projection", camera->GetProjection().projection);
-			object.data.shader.SetMat4("view", camera->GetProjection().view);
-			object.data.shader.SetMat4("model", transform);
+		if (found != instanceBatches.end())
+			return found->second;
+
+		InstanceBatch& batch = instanceBatches[key];
+
+		glGenBuffers(1, &batch.buffer);
+
+		return batch;
+	}
+
+	// Points the bound VAO's instance attributes at buffer, which must be bound to GL_ARRAY_BUFFER; skipped when they already are.
+	void PointInstanceAttributes(unsigned int VAO, unsigned int buffer)
+	{
+		unsigned int& current = instanceAttributeBuffers[VAO];
+
+		if (current == buffer)
+			return;
 
-			if (object.data.doDefaultLighting)
+		current = buffer;
+
+		for (int c = 0; c < 4; ++c)
+		{
+			glVertexAttribPointer(instanceAttributeLocation + c, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(offsetof(InstanceData, model) + c * sizeof(glm::vec4)));
+			glEnableVertexAttribArray(instanceAttributeLocation + c);
+			glVertexAttribDivisor(instanceAttributeLocation + c, 1);
+		}
+
+		for (int c = 0; c < 3; ++c)
+		{
+			glVertexAttribPointer(instanceAttributeLocation + 4 + c, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(offsetof(InstanceData, normal) + c * sizeof(glm::vec3)));
+			glEnableVertexAttribArray(instanceAttributeLocation + 4 + c);
+			glVertexAttribDivisor(instanceAttributeLocation + 4 + c, 1);
+		}
+
+		glVertexAttribPointer(instanceAttributeLocation + 7, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)offsetof(InstanceData, tint));
+		glEnableVertexAttribArray(instanceAttributeLocation + 7);
+		glVertexAttribDivisor(instanceAttributeLocation + 7, 1);
+	}
+
+	void DrawInstanceBatch(InstanceBatch& batch)
+	{
+		GLState::BindBuffer(GL_ARRAY_BUFFER, batch.buffer);
+
+		// Orphans last frame's storage so the driver never waits on draws still reading it.
+		if (batch.instances.size() > batch.capacity)
+			batch.capacity = std::max(batch.instances.size(), batch.capacity * 2);
+
+		glBufferData(GL_ARRAY_BUFFER, batch.capacity * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, batch.instances.size() * sizeof(InstanceData), batch.instances.data());
+
+		RenderableObject& object = *batch.first;
+
+		ApplyObjectState(object);
+		PointInstanceAttributes(object.VAO, batch.buffer);
+
+		glDrawElementsInstanced(GL_TRIANGLES, object.indexCount, GL_UNSIGNED_INT, 0, static_cast<GLsizei>(batch.instances.size()));
+	}
+
+	void Submit(const DrawItem& item)
+	{
+		if (item.instanced)
+		{
+			DrawInstanceBatch(*queuedBatches[item.index]);
+			return;
+		}
+
+		RenderableObject& object = registeredObjects[item.index];
+
+		ApplyObjectState(object);
+
+		object.data.shader.SetMat4(GetObjectUniforms(object.data.shader).model, GetInstance(object).model);
+
+		glDrawElements(GL_TRIANGLES, object.indexCount, GL_UNSIGNED_INT, 0);
+	}
+
+	// Queues this frame's draws and submits the opaque pass. Objects whose program reads instance attributes are gathered into
+	// one batch per VAO and program and queued once; any other object is queued on its own and drawn with the model uniform.
+	void RenderObjects(std::shared_ptr<Camera>& camera)
+	{
+		RemoveOrphanedObjects();
+
+		FrameUniforms::Update(camera, directionalLight, lights);
+
+		for (auto& [key, batch] : instanceBatches)
+		{
+			batch.first = nullptr;
+			batch.instances.clear();
+		}
+
+		glm::mat4 view = camera->GetProjection().view;
+		InstanceBatch* batch = nullptr;
+
+		renderQueue.Clear();
+		queuedBatches.clear();
+
+		for (std::uint32_t o = 0; o < registeredObjects.size(); ++o)
+		{
+			RenderableObject& object = registeredObjects[o];
+
+			if (!object.data.shader.instanced)
 			{
-				for (int l = 0; l < lights.size(); ++l)
-				{
-					object.data.shader.SetVec3("viewPos", camera->transform.position);
-					object.data.shader.SetFloat("material.shininess", 32.0f);
-
-					object.data.shader.SetVec3("dirLight.direction", directionalLight->direction);
-					object.data.shader.SetVec3("dirLight.ambient", directionalLight->ambient);
-					object.data.shader.SetVec3("dirLight.diffuse", directionalLight->diffuse);
-					object.data.shader.SetVec3("dirLight.specular", directionalLight->specular);
-
-					object.data.shader.SetVec3("pointLights[" + std::to_string(l) + "].position", lights[l]->transform.position);
-					object.data.shader.SetVec3("pointLights[" + std::to_string(l) + "].ambient", lights[l]->ambient);
-					object.data.shader.SetVec3("pointLights[" + std::to_string(l) + "].diffuse", lights[l]->diffuse);
-					object.data.shader.SetVec3("pointLights[" + std::to_string(l) + "].specular", lights[l]->specular);
-					object.data.shader.SetFloat("pointLights[" + std::to_string(l) + "].constant", 1.0f);
-					object.data.shader.SetFloat("pointLights[" + std::to_string(l) + "].linear", 0.09f);
-					object.data.shader.SetFloat("pointLights[" + std::to_string(l) + "].quadratic", 0.032f);
-
-					object.data.shader.SetVec3("spotLight.position", camera->transform.position);
-					object.data.shader.SetVec3("spotLight.direction", qtov(camera->transform.rotation));
-					object.data.shader.SetVec3("spotLight.ambient", glm::vec3{ 0.0f, 0.0f, 0.0f });
-					object.data.shader.SetVec3("spotLight.diffuse", glm::vec3{ 0.0f, 0.0f, 0.0f });
-					object.data.shader.SetVec3("spotLight.specular", glm::vec3{ 1.0f, 1.0f, 1.0f });
-					object.data.shader.SetFloat("spotLight.constant", 1.0f);
-					object.data.shader.SetFloat("spotLight.linear", 0.09f);
-					object.data.shader.SetFloat("spotLight.quadratic", 0.032f);
-					object.data.shader.SetFloat("spotLight.cutOff", glm::cos(glm::radians(12.5f)));
-					object.data.shader.SetFloat("spotLight.outerCutOff", glm::cos(glm::radians(17.0f)));
-				}
+				float depth = -(view * GetInstance(object).model[3]).z;
+				int pass = object.data.transparent ? transparentPass : opaquePass;
+
+				renderQueue.Push(RenderQueue::MakeKey(pass, object.data.shader.ID, GetMaterial(object), object.VAO, depth), o, false);
+				continue;
+			}
+
+			// Copies of one mesh are usually registered together, so the last batch is tried before the lookup.
+			if (!batch || batch->first->VAO != object.VAO || batch->first->data.shader.ID != object.data.shader.ID)
+				batch = &GetInstanceBatch(object);
+
+			if (!batch->first)
+				batch->first = &object;
+
+			batch->instances.push_back(GetInstance(object));
+		}
+
+		// A batch left empty may belong to a VAO that is about to be deleted, so its buffer goes with it.
+		for (auto current = instanceBatches.begin(); current != instanceBatches.end();)
+		{
+			InstanceBatch& queued = current->second;
+
+			if (queued.instances.empty())
+			{
+				// GL may hand the buffer name out again, so no VAO may be remembered as pointing at it.
+				std::erase_if(instanceAttributeBuffers, [&](const auto& entry) { return entry.second == queued.buffer; });
+
+				GLState::DeleteBuffer(queued.buffer);
+				current = instanceBatches.erase(current);
+				continue;
 			}
 
-			PostShaderCalls();
- 
-			glBindVertexArray(object.VAO);
-			glDrawElements(GL_TRIANGLES, object.data.indices.size(), GL_UNSIGNED_INT, 0);
+			float depth = -(view * queued.instances[0].model[3]).z;
+
+			renderQueue.Push(RenderQueue::MakeKey(opaquePass, queued.first->data.shader.ID, GetMaterial(*queued.first), queued.first->VAO, depth), static_cast<std::uint32_t>(queuedBatches.size()), true);
+			queuedBatches.push_back(&queued);
+
+			++current;
 		}
+
+		renderQueue.Sort();
+
+		const std::vector<DrawItem>& items = renderQueue.GetItems();
+
+		transparentBegin = 0;
+
+		for (; transparentBegin < items.size() && RenderQueue::GetPass(items[transparentBegin].key) == opaquePass; ++transparentBegin)
+			Submit(items[transparentBegin]);
+	}
+
+	// Submits the transparent items queued by RenderObjects; call after everything opaque, the skybox included, has been drawn.
+	void RenderTransparentObjects()
+	{
+		const std::vector<DrawItem>& items = renderQueue.GetItems();
+
+		if (transparentBegin >= items.size())
+			return;
+
+		GLState::DepthMask(false);
+
+		for (std::size_t i = transparentBegin; i < items.size(); ++i)
+			Submit(items[i]);
+
+		GLState::DepthMask(true);
 	}
 };
 
@@ -581,5 +828,11 @@ std::vector<RenderableObject> Renderer::registeredObjects;
 std::vector<std::shared_ptr<PointLight>> Renderer::lights;
 std::deque<ShaderCall> Renderer::shaderCalls;
 std::shared_ptr<DirectionalLight> Renderer::directionalLight;
+std::unordered_map<std::uint64_t, InstanceBatch> Renderer::instanceBatches;
+std::unordered_map<unsigned int, unsigned int> Renderer::instanceAttributeBuffers;
+std::unordered_map<unsigned int, ObjectUniforms> Renderer::objectUniforms;
+RenderQueue Renderer::renderQueue;
+std::vector<InstanceBatch*> Renderer::queuedBatches;
+std::size_t Renderer::transparentBegin = 0;
 
 #endif // !RENDERER_HPP
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -12,7 +13,16 @@
 #include <GLFW/glfw3.h>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat2x2.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
 #include "core/Logger.hpp"
+#include "rendering/GLState.hpp"
+
+// Fixed binding points of the uniform blocks every program shares; FrameUniforms fills them once per frame.
+#define cameraBlockBinding 0
+#define lightsBlockBinding 1
 
 struct ShaderLoadPair
 {
@@ -55,6 +65,17 @@ struct ShaderLoadPair
     }
 };
 
+// A uniform location resolved once from a linked program; setters taking one skip the name lookup entirely.
+struct UniformHandle
+{
+    int location = -1;
+
+    bool IsValid() const
+    {
+        return location != -1;
+    }
+};
+
 struct ShaderObject
 {
     std::string name;
@@ -64,6 +85,12 @@ struct ShaderObject
 
     unsigned int ID;
 
+    // Set for programs that read their model matrix from per-instance attributes instead of the model uniform.
+    bool instanced = false;
+
+    // Every active uniform of the linked program by name, shared by all copies of this ShaderObject.
+    std::shared_ptr<std::unordered_map<std::string, int>> uniforms;
+
     static ShaderObject Register(const std::string& localPath, const std::string& name)
     {
         ShaderObject out;
@@ -128,71 +155,194 @@ struct ShaderObject
 
         glDeleteShader(vertex);
         glDeleteShader(fragment);
+
+        instanced = glGetAttribLocation(ID, "aModel") != -1;
+
+        BindUniformBlock("Camera", cameraBlockBinding);
+        BindUniformBlock("Lights", lightsBlockBinding);
+
+        ReflectUniforms();
+    }
+
+    // Programs that do not declare the block are left alone.
+    void BindUniformBlock(const std::string& name, unsigned int binding)
+    {
+        unsigned int index = glGetUniformBlockIndex(ID, name.c_str());
+
+        if (index != GL_INVALID_INDEX)
+            glUniformBlockBinding(ID, index, binding);
+    }
+
+    // False when the program was already bound and the call was dropped.
+    bool Use()
+    {
+        return GLState::UseProgram(ID);
+    }
+
+    // Resolve handles once, outside the frame; names the program does not use give an invalid handle, which setters ignore.
+    UniformHandle GetUniform(const std::string& name) const
+    {
+        if (!uniforms)
+            return {};
+
+        auto found = uniforms->find(name);
+
+        return found != uniforms->end() ? UniformHandle{ found->second } : UniformHandle{};
+    }
+
+    void SetBool(UniformHandle uniform, const bool& value) const
+    {
+        glUniform1i(uniform.location, (int)value);
+    }
+
+    void SetInt(UniformHandle uniform, const int& value) const
+    {
+        glUniform1i(uniform.location, value);
+    }
+
+    void SetFloat(UniformHandle uniform, const float& value) const
+    {
+        glUniform1f(uniform.location, value);
+    }
+
+    void SetVec2(UniformHandle uniform, const glm::vec2& value) const
+    {
+        glUniform2fv(uniform.location, 1, &value[0]);
     }
 
-    void Use()
+    void SetVec3(UniformHandle uniform, const glm::vec3& value) const
     {
-        glUseProgram(ID);
+        glUniform3fv(uniform.location, 1, &value[0]);
+    }
+
+    void SetVec3(UniformHandle uniform, float x, float y, float z) const
+    {
+        glUniform3f(uniform.location, x, y, z);
+    }
+
+    void SetVec4(UniformHandle uniform, const glm::vec4& value) const
+    {
+        glUniform4fv(uniform.location, 1, &value[0]);
+    }
+
+    void SetMat2(UniformHandle uniform, const glm::mat2& mat) const
+    {
+        glUniformMatrix2fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
+    }
+
+    void SetMat3(UniformHandle uniform, const glm::mat3& mat) const
+    {
+        glUniformMatrix3fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
+    }
+
+    void SetMat4(UniformHandle uniform, const glm::mat4& mat) const
+    {
+        glUniformMatrix4fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
     }
 
     void SetBool(const std::string& name, const bool& value) const
     {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+        glUniform1i(GetUniform(name).location, (int)value);
     }
 
     void SetInt(const std::string& name, const int& value) const
     {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+        glUniform1i(GetUniform(name).location, value);
     }
 
     void SetFloat(const std::string& name, const float& value) const
     {
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+        glUniform1f(GetUniform(name).location, value);
     }
 
     void SetVec2(const std::string& name, const glm::vec2& value) const
     {
-        glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        glUniform2fv(GetUniform(name).location, 1, &value[0]);
     }
 
     void SetVec2(const std::string& name, float x, float y) const
     {
-        glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+        glUniform2f(GetUniform(name).location, x, y);
     }
 
     void SetVec3(const std::string& name, const glm::vec3& value) const
     {
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        glUniform3fv(GetUniform(name).location, 1, &value[0]);
     }
 
     void SetVec3(const std::string& name, float x, float y, float z) const
     {
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+        glUniform3f(GetUniform(name).location, x, y, z);
     }
 
     void SetVec4(const std::string& name, const glm::vec4& value) const
     {
-        glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        glUniform4fv(GetUniform(name).location, 1, &value[0]);
     }
 
     void SetVec4(const std::string& name, float x, float y, float z, float w) const
     {
-        glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+        glUniform4f(GetUniform(name).location, x, y, z, w);
     }
 
     void SetMat2(const std::string& name, const glm::mat2& mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix2fv(GetUniform(name).location, 1, GL_FALSE, &mat[0][0]);
     }
 
     void SetMat3(const std::string& name, const glm::mat3& mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix3fv(GetUniform(name).location, 1, GL_FALSE, &mat[0][0]);
     }
 
     void SetMat4(const std::string& name, const glm::mat4& mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix4fv(GetUniform(name).location, 1, GL_FALSE, &mat[0][0]);
+    }
+
+    // Arrays of plain types report only their first element, so the remaining elements are looked up here as well.
+    void ReflectUniforms()
+    {
+        uniforms = std::make_shared<std::unordered_map<std::string, int>>();
+
+        GLint count = 0;
+        GLint maxLength = 0;
+
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+        std::vector<GLchar> buffer(static_cast<std::size_t>(maxLength) + 1);
+
+        for (GLint u = 0; u < count; ++u)
+        {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+
+            glGetActiveUniform(ID, static_cast<GLuint>(u), static_cast<GLsizei>(buffer.size()), &length, &size, &type, buffer.data());
+
+            std::string name(buffer.data(), length);
+            int location = glGetUniformLocation(ID, name.c_str());
+
+            if (location == -1)
+                continue;
+
+            (*uniforms)[name] = location;
+
+            if (name.size() < 3 || name.compare(name.size() - 3, 3, "[0]") != 0)
+                continue;
+
+            std::string base = name.substr(0, name.size() - 3);
+
+            (*uniforms)[base] = location;
+
+            for (GLint e = 1; e < size; ++e)
+            {
+                std::string element = base + "[" + std::to_string(e) + "]";
+
+                (*uniforms)[element] = glGetUniformLocation(ID, element.c_str());
+            }
+        }
     }
 
     void CheckForCompileErrors(GLuint shader, std::string type)
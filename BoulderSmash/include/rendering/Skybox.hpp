@@ -7,6 +7,7 @@
 #include "components/Transform.hpp"
 #include "rendering/Camera.hpp"
 #include "rendering/Cubemap.hpp"
+#include "rendering/GLState.hpp"
 #include "rendering/ShaderManager.hpp"
 
 unsigned int VAO, VBO;
@@ -17,11 +18,17 @@ Transform transform;
 
 namespace Skybox
 {
+    extern UniformHandle viewUniform;
+    extern UniformHandle projectionUniform;
+
     void InternalInit(ShaderObject type)
     {
         cubemap = std::make_shared<Cubemap>();
         shader = type;
         shader.BindShader();
+
+        viewUniform = shader.GetUniform("view");
+        projectionUniform = shader.GetUniform("projection");
     }
 
 	void GenerateSkybox(CubemapContainer container, ShaderObject type = ShaderManager::GetShader("skyboxShader"))
@@ -90,22 +97,20 @@ namespace Skybox
 
 	void Render(const std::shared_ptr<Camera>& camera)
 	{
-		glDepthFunc(GL_LEQUAL);
-		glDisable(GL_CULL_FACE);
+		GLState::DepthFunc(GL_LEQUAL);
+		GLState::SetCapability(GL_CULL_FACE, false);
 
         shader.Use();
 
-        shader.SetMat4("view", glm::mat4(glm::mat3(camera->GetProjection().view)));
-        shader.SetMat4("projection", camera->GetProjection().projection);
+        shader.SetMat4(viewUniform, glm::mat4(glm::mat3(camera->GetProjection().view)));
+        shader.SetMat4(projectionUniform, camera->GetProjection().projection);
 
-        glBindVertexArray(VAO);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap->GetTextureID());
+        GLState::BindVertexArray(VAO);
+        GLState::BindTexture(0, GL_TEXTURE_CUBE_MAP, cubemap->GetTextureID());
         glDrawArrays(GL_TRIANGLES, 0, 36);
-        glBindVertexArray(0);
 
-		glDepthFunc(GL_LESS);
-		glEnable(GL_CULL_FACE);
+		GLState::DepthFunc(GL_LESS);
+		GLState::SetCapability(GL_CULL_FACE, true);
 	}
 
     void CleanUp()
@@ -115,4 +120,7 @@ namespace Skybox
     }
 };
 
+UniformHandle Skybox::viewUniform;
+UniformHandle Skybox::projectionUniform;
+
 #endif // !SKYBOX_HPP
\ No newline at end of file
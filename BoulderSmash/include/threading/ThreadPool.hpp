@@ -0,0 +1,133 @@
+#ifndef THREAD_POOL
+#define THREAD_POOL
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <functional>
+
+class ThreadPool
+{
+
+public:
+
+    ThreadPool(std::size_t workerCount)
+    {
+        for (std::size_t w = 0; w < workerCount; ++w)
+            workers.emplace_back([this] { run(); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            stop = true;
+        }
+
+        cv.notify_all();
+
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    // Runs job(0) ... job(count - 1) across the workers and the calling thread, returning once every index is done.
+    void Dispatch(std::size_t count, const std::function<void(std::size_t)>& job)
+    {
+        if (count == 0)
+            return;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            this->job = &job;
+            jobCount = count;
+            next = 0;
+            remaining = count;
+            activeWorkers = workers.size();
+            round++;
+        }
+
+        cv.notify_all();
+
+        runJobs();
+
+        std::unique_lock<std::mutex> lock(mutex);
+
+        doneCv.wait(lock, [this]
+        {
+            return remaining == 0 && activeWorkers == 0;
+        });
+
+        this->job = nullptr;
+    }
+
+    std::size_t GetWorkerCount() const
+    {
+        return workers.size() + 1;
+    }
+
+private:
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::condition_variable doneCv;
+
+    const std::function<void(std::size_t)>* job = nullptr;
+    std::size_t jobCount = 0;
+    std::atomic<std::size_t> next = 0;
+    std::atomic<std::size_t> remaining = 0;
+    std::size_t activeWorkers = 0;
+    std::size_t round = 0;
+    bool stop = false;
+
+    void runJobs()
+    {
+        while (true)
+        {
+            std::size_t index = next.fetch_add(1);
+
+            if (index >= jobCount)
+                return;
+
+            (*job)(index);
+
+            remaining.fetch_sub(1);
+        }
+    }
+
+    void run()
+    {
+        std::size_t seenRound = 0;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+
+                cv.wait(lock, [this, seenRound]
+                {
+                    return stop || round != seenRound;
+                });
+
+                if (stop)
+                    return;
+
+                seenRound = round;
+            }
+
+            runJobs();
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                activeWorkers--;
+            }
+
+            doneCv.notify_all();
+        }
+    }
+};
+
+#endif // !THREAD_POOL
\ No newline at end of file
@@ -41,12 +41,14 @@ public:
 
 private:
 
-    std::thread worker;
     std::mutex mutex;
     std::condition_variable cv;
     std::queue<std::function<void()>> tasks;
     bool stop = false;
 
+    // Declared last so the thread only starts once the members it waits on are constructed.
+    std::thread worker;
+
     void run()
     {
         while (true)
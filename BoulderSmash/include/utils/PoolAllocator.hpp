@@ -0,0 +1,139 @@
+#ifndef POOL_ALLOCATOR_HPP
+#define POOL_ALLOCATOR_HPP
+
+#include <atomic>
+#include <algorithm>
+#include <vector>
+#include <new>
+#include <utility>
+
+namespace AllocationCounter
+{
+	extern std::atomic<std::size_t> allocations;
+	extern std::atomic<std::size_t> deallocations;
+
+	void* Allocate(std::size_t size, std::size_t alignment)
+	{
+		allocations++;
+		return ::operator new(size, std::align_val_t(alignment));
+	}
+
+	void Deallocate(void* pointer, std::size_t alignment)
+	{
+		if (!pointer)
+			return;
+
+		deallocations++;
+		::operator delete(pointer, std::align_val_t(alignment));
+	}
+}
+
+std::atomic<std::size_t> AllocationCounter::allocations = 0;
+std::atomic<std::size_t> AllocationCounter::deallocations = 0;
+
+class PoolAllocator
+{
+
+public:
+
+	PoolAllocator(std::size_t blockSize, std::size_t blockAlignment, std::size_t blocksPerSlab = 1024) : blocksPerSlab(blocksPerSlab)
+	{
+		alignment = std::max(blockAlignment, alignof(FreeBlock));
+		this->blockSize = (std::max(blockSize, sizeof(FreeBlock)) + alignment - 1) & ~(alignment - 1);
+	}
+
+	~PoolAllocator()
+	{
+		for (unsigned char* slab : slabs)
+			AllocationCounter::Deallocate(slab, alignment);
+	}
+
+	PoolAllocator(const PoolAllocator&) = delete;
+	PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+	void* Allocate()
+	{
+		if (!freeList)
+			AddSlab();
+
+		FreeBlock* block = freeList;
+		freeList = block->next;
+		activeBlocks++;
+
+		return block;
+	}
+
+	void Deallocate(void* pointer)
+	{
+		FreeBlock* block = static_cast<FreeBlock*>(pointer);
+
+		block->next = freeList;
+		freeList = block;
+		activeBlocks--;
+	}
+
+	std::size_t GetActiveCount() const
+	{
+		return activeBlocks;
+	}
+
+	std::size_t GetCapacity() const
+	{
+		return slabs.size() * blocksPerSlab;
+	}
+
+private:
+
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+
+	void AddSlab()
+	{
+		unsigned char* slab = static_cast<unsigned char*>(AllocationCounter::Allocate(blockSize * blocksPerSlab, alignment));
+
+		slabs.push_back(slab);
+
+		for (std::size_t b = blocksPerSlab; b-- > 0;)
+		{
+			FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + b * blockSize);
+
+			block->next = freeList;
+			freeList = block;
+		}
+	}
+
+	std::vector<unsigned char*> slabs;
+	FreeBlock* freeList = nullptr;
+
+	std::size_t blockSize;
+	std::size_t alignment;
+	std::size_t blocksPerSlab;
+	std::size_t activeBlocks = 0;
+};
+
+template<typename T>
+class ObjectPool
+{
+
+public:
+
+	ObjectPool(std::size_t objectsPerSlab = 1024) : allocator(sizeof(T), alignof(T), objectsPerSlab) { }
+
+	template<typename... TArgs>
+	T* Create(TArgs&&... args)
+	{
+		return new (allocator.Allocate()) T(std::forward<TArgs>(args)...);
+	}
+
+	void Destroy(T* object)
+	{
+		object->~T();
+		allocator.Deallocate(object);
+	}
+
+	PoolAllocator allocator;
+};
+
+#endif // !POOL_ALLOCATOR_HPP
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "TestHelpers.hpp"
+#include <cstdlib>
+#include <random>
+#include "components/BoxCollider.hpp"
+#include "physics/AABBBatch.hpp"
+
+std::vector<AABBOverlapPath> GetSupportedPaths()
+{
+	std::vector<AABBOverlapPath> paths = { AABBOverlapPath::SCALAR };
+
+#ifdef aabbBatchSimd
+	paths.push_back(AABBOverlapPath::SSE);
+
+	if (AABBOverlap::SupportsAVX2())
+		paths.push_back(AABBOverlapPath::AVX2);
+#endif
+
+	return paths;
+}
+
+const char* GetPathName(AABBOverlapPath path)
+{
+	return path == AABBOverlapPath::AVX2 ? "avx2" : path == AABBOverlapPath::SSE ? "sse" : "scalar";
+}
+
+std::vector<std::uint64_t> TestOn(AABBOverlapPath path, const AABB& box, const AABBBatch& batch)
+{
+	std::vector<std::uint64_t> mask;
+
+	AABBOverlap::path = path;
+	AABBOverlap::Test(box, batch, mask);
+
+	return mask;
+}
+
+void Fill(std::mt19937& random, std::size_t count, AABBBatch& batch)
+{
+	std::uniform_real_distribution<float> position(0.0f, 40.0f);
+	std::uniform_real_distribution<float> size(0.5f, 8.0f);
+
+	batch.Clear();
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		glm::vec3 min{ position(random), position(random), position(random) };
+
+		batch.Add(AABB::Register(min, min + glm::vec3{ size(random), size(random), size(random) }));
+	}
+}
+
+// Every size up to three mask words covers each tail the 4- and 8-wide loops can leave, and a mask word boundary inside a vector.
+void TestPathsMatch()
+{
+	std::mt19937 random(13);
+	std::vector<AABBOverlapPath> paths = GetSupportedPaths();
+	AABBBatch batch;
+	AABB box = AABB::Register(glm::vec3{ 15.0f }, glm::vec3{ 25.0f });
+
+	std::printf("Comparing paths:");
+
+	for (AABBOverlapPath path : paths)
+		std::printf(" %s", GetPathName(path));
+
+	std::printf("\n");
+
+	for (std::size_t count = 0; count <= 200; ++count)
+	{
+		Fill(random, count, batch);
+
+		std::vector<std::uint64_t> expected = TestOn(AABBOverlapPath::SCALAR, box, batch);
+
+		check(expected.size() == (count + 63) / 64);
+
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			AABB other = AABB::Register({ batch.minX[i], batch.minY[i], batch.minZ[i] }, { batch.maxX[i], batch.maxY[i], batch.maxZ[i] });
+
+			check(static_cast<bool>((expected[i >> 6] >> (i & 63)) & 1) == box.Overlaps(other));
+		}
+
+		for (AABBOverlapPath path : paths)
+			check(TestOn(path, box, batch) == expected);
+	}
+
+	// Boxes that only share a face are not overlapping on any path, wherever they sit in the vector or the tail.
+	batch.Clear();
+
+	for (int i = 0; i < 13; ++i)
+		batch.Add(i % 2 == 0 ? AABB::Register(glm::vec3{ 25.0f, 15.0f, 15.0f }, glm::vec3{ 30.0f }) : AABB::Register(glm::vec3{ 24.9f, 15.0f, 15.0f }, glm::vec3{ 30.0f }));
+
+	for (AABBOverlapPath path : paths)
+		check(TestOn(path, box, batch) == std::vector<std::uint64_t>{ 0xAAAull });
+
+	AABBOverlap::path = AABBOverlap::SelectPath();
+}
+
+void Measure(std::size_t count)
+{
+	std::mt19937 random(4);
+	AABBBatch batch;
+	std::vector<BoxCollider> colliders;
+	std::vector<std::uint64_t> mask;
+	BoxCollider self = BoxCollider::Register(TRANSFORM_POSITION(15.0f, 15.0f, 15.0f), glm::vec3{ 10.0f }, false);
+
+	Fill(random, count, batch);
+
+	for (std::size_t i = 0; i < count; ++i)
+		colliders.push_back(BoxCollider::Register(TRANSFORM_POSITION(batch.minX[i], batch.minY[i], batch.minZ[i]), glm::vec3{ batch.maxX[i] - batch.minX[i], batch.maxY[i] - batch.minY[i], batch.maxZ[i] - batch.minZ[i] }, false));
+
+	// What the batch replaced: one collider against each other collider in turn.
+	int hits = 0;
+
+	double loop = TestHelpers::Measure([&]()
+	{
+		hits = 0;
+
+		for (const BoxCollider& collider : colliders)
+			hits += self.IsCollidingWith(collider);
+	});
+
+	std::printf("One box against %zu (best of 5, ms), %d hits: collider loop %.3f", count, hits, loop);
+
+	for (AABBOverlapPath path : GetSupportedPaths())
+	{
+		AABBOverlap::path = path;
+
+		double time = TestHelpers::Measure([&]() { AABBOverlap::Test(self.GetBounds(), batch, mask); });
+
+		std::printf(", %s %.3f", GetPathName(path), time);
+	}
+
+	std::printf("\n");
+
+	AABBOverlap::path = AABBOverlap::SelectPath();
+}
+
+int main(int argc, char** argv)
+{
+	TestPathsMatch();
+	Measure(argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100003);
+
+	return TestHelpers::Finish("AABBBatchTests");
+}
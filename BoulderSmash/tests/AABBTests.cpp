@@ -0,0 +1,115 @@
+#include "TestHelpers.hpp"
+#include <cmath>
+#include "physics/AABB.hpp"
+
+AABB Box(const glm::vec3& min, const glm::vec3& size)
+{
+	return AABB::Register(min, min + size);
+}
+
+bool Near(float a, float b)
+{
+	return std::abs(a - b) < 1e-5f;
+}
+
+void TestSweep()
+{
+	float timeOfImpact = -1.0f;
+
+	// A unit box moving ten units reaches a wall a fifth of a unit thick after a fifth of the step, although it starts and ends clear of it.
+	AABB wall = Box({ 3.0f, -5.0f, -5.0f }, { 0.2f, 10.0f, 10.0f });
+
+	check(!Box({ 0.0f, 0.0f, 0.0f }, glm::vec3{ 1.0f }).Overlaps(wall) && !Box({ 10.0f, 0.0f, 0.0f }, glm::vec3{ 1.0f }).Overlaps(wall));
+	check(AABB::Sweep(Box(glm::vec3{ 0.0f }, glm::vec3{ 1.0f }), { 10.0f, 0.0f, 0.0f }, wall, glm::vec3{ 0.0f }, timeOfImpact) && Near(timeOfImpact, 0.2f));
+
+	// Only the relative motion counts: the same wall sweeping into a resting box meets it at the same moment.
+	check(AABB::Sweep(wall, { -10.0f, 0.0f, 0.0f }, Box(glm::vec3{ 0.0f }, glm::vec3{ 1.0f }), glm::vec3{ 0.0f }, timeOfImpact) && Near(timeOfImpact, 0.2f));
+
+	// Two boxes closing head-on at four units each cover the four-unit gap halfway through.
+	check(AABB::Sweep(Box(glm::vec3{ 0.0f }, glm::vec3{ 1.0f }), { 4.0f, 0.0f, 0.0f }, Box({ 5.0f, 0.0f, 0.0f }, glm::vec3{ 1.0f }), { -4.0f, 0.0f, 0.0f }, timeOfImpact) && Near(timeOfImpact, 0.5f));
+
+	// One chasing the other catches it only when faster.
+	check(AABB::Sweep(Box(glm::vec3{ 0.0f }, glm::vec3{ 1.0f }), { 6.0f, 0.0f, 0.0f }, Box({ 2.0f, 0.0f, 0.0f }, glm::vec3{ 1.0f }), { 2.0f, 0.0f, 0.0f }, timeOfImpact) && Near(timeOfImpact, 0.25f));
+	check(!AABB::Sweep(Box(glm::vec3{ 0.0f }, glm::vec3{ 1.0f }), { 6.0f, 0.0f, 0.0f }, Box({ 2.0f, 0.0f, 0.0f }, glm::vec3{ 1.0f }), { 6.0f, 0.0f, 0.0f }, timeOfImpact));
+
+	// Boxes on a diagonal meet when the last axis closes, not the first.
+	check(AABB::Sweep(Box(glm::vec3{ 0.0f }, glm::vec3{ 1.0f }), { 4.0f, 8.0f, 0.0f }, Box({ 2.0f, 5.0f, 0.0f }, glm::vec3{ 1.0f }), glm::vec3{ 0.0f }, timeOfImpact) && Near(timeOfImpact, 0.5f));
+
+	// Boxes already overlapping hit at 0, whichever way they move, even apart.
+	timeOfImpact = -1.0f;
+	check(AABB::Sweep(Box(glm::vec3{ 0.0f }, glm::vec3{ 1.0f }), { -5.0f, 0.0f, 0.0f }, Box({ 0.5f, 0.5f, 0.5f }, glm::vec3{ 1.0f }), { 5.0f, 0.0f, 0.0f }, timeOfImpact) && timeOfImpact == 0.0f);
+
+	timeOfImpact = -1.0f;
+	check(AABB::Sweep(Box(glm::vec3{ 0.0f }, glm::vec3{ 1.0f }), glm::vec3{ 0.0f }, Box(glm::vec3{ 0.25f }, glm::vec3{ 0.5f }), glm::vec3{ 0.0f }, timeOfImpact) && timeOfImpact == 0.0f);
+}
+
+// Near misses must not report a hit, although the volumes the boxes sweep overlap, which is all the broadphase sees.
+void TestSweepNearMisses()
+{
+	float timeOfImpact = 0.5f;
+	AABB box = Box(glm::vec3{ 0.0f }, glm::vec3{ 1.0f });
+
+	// Passing a hundredth of a unit beside the wall.
+	check(!AABB::Sweep(box, { 10.0f, 0.0f, 0.0f }, Box({ 3.0f, 1.01f, 0.0f }, { 0.2f, 5.0f, 1.0f }), glm::vec3{ 0.0f }, timeOfImpact));
+
+	// Cutting past a corner: x closes after half the step, but y has already separated a quarter of the way in.
+	check(!AABB::Sweep(box, { 4.0f, 4.0f, 0.0f }, Box({ 3.0f, 0.0f, 0.0f }, glm::vec3{ 1.0f }), glm::vec3{ 0.0f }, timeOfImpact));
+	check(AABB::Union(box, Box({ 4.0f, 4.0f, 0.0f }, glm::vec3{ 1.0f })).Overlaps(Box({ 3.0f, 0.0f, 0.0f }, glm::vec3{ 1.0f })));
+
+	// Stopping short of the wall, and reaching it only at the very end of the step.
+	check(!AABB::Sweep(box, { 1.9f, 0.0f, 0.0f }, Box({ 3.0f, 0.0f, 0.0f }, glm::vec3{ 1.0f }), glm::vec3{ 0.0f }, timeOfImpact));
+	check(!AABB::Sweep(box, { 2.0f, 0.0f, 0.0f }, Box({ 3.0f, 0.0f, 0.0f }, glm::vec3{ 1.0f }), glm::vec3{ 0.0f }, timeOfImpact));
+
+	// Sliding along a face they share: touching is not overlapping.
+	check(!AABB::Sweep(box, { 5.0f, 0.0f, 0.0f }, Box({ 2.0f, 1.0f, 0.0f }, glm::vec3{ 1.0f }), glm::vec3{ 0.0f }, timeOfImpact));
+
+	// Moving away from a box in front.
+	check(!AABB::Sweep(box, { -5.0f, 0.0f, 0.0f }, Box({ 2.0f, 0.0f, 0.0f }, glm::vec3{ 1.0f }), glm::vec3{ 0.0f }, timeOfImpact));
+
+	// A miss leaves the caller's value alone.
+	check(timeOfImpact == 0.5f);
+}
+
+bool CastRay(const AABB& box, const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float& distance)
+{
+	return box.IntersectsRay(origin, 1.0f / direction, maxDistance, distance);
+}
+
+void TestIntersectsRay()
+{
+	AABB box = Box(glm::vec3{ 0.0f }, glm::vec3{ 1.0f });
+	float distance = -1.0f;
+
+	check(CastRay(box, { -5.0f, 0.5f, 0.5f }, glm::normalize(glm::vec3{ 1.0f, 0.05f, 0.0f }), 100.0f, distance) && std::abs(distance - 5.0f * std::sqrt(1.0025f)) < 1e-4f);
+	check(!CastRay(box, { -5.0f, 0.5f, 0.5f }, { -1.0f, 0.0f, 0.0f }, 100.0f, distance));
+	check(!CastRay(box, { -5.0f, 0.5f, 0.5f }, { 1.0f, 0.0f, 0.0f }, 4.0f, distance));
+
+	// Starting inside enters at 0.
+	check(CastRay(box, glm::vec3{ 0.5f }, { 0.0f, 0.0f, 1.0f }, 100.0f, distance) && distance == 0.0f);
+
+	// Axis-aligned rays have zero components, whose infinite inverse times a zero offset is a NaN; the origins here sit exactly on the slab planes.
+	check(CastRay(box, { -5.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, 100.0f, distance) && distance == 5.0f);
+	check(CastRay(box, { -5.0f, 1.0f, 0.5f }, { 1.0f, 0.0f, 0.0f }, 100.0f, distance) && distance == 5.0f);
+	check(CastRay(box, { 0.5f, 0.0f, 9.0f }, { 0.0f, 0.0f, -1.0f }, 100.0f, distance) && distance == 8.0f);
+	check(CastRay(box, { 0.0f, 0.5f, 0.5f }, { 1.0f, 0.0f, 0.0f }, 100.0f, distance) && distance == 0.0f);
+
+	// Negative zero gives a negative infinity, which must be treated the same.
+	check(CastRay(box, { -5.0f, 0.0f, 0.5f }, { 1.0f, -0.0f, 0.0f }, 100.0f, distance) && distance == 5.0f);
+
+	// Parallel to a slab and outside it, however near, is a miss on every other axis too.
+	check(!CastRay(box, { -5.0f, 1.001f, 0.5f }, { 1.0f, 0.0f, 0.0f }, 100.0f, distance));
+	check(!CastRay(box, { -5.0f, 0.5f, -0.001f }, { 1.0f, 0.0f, 0.0f }, 100.0f, distance));
+	check(!CastRay(box, { 5.0f, 5.0f, 0.5f }, { 0.0f, -1.0f, 0.0f }, 100.0f, distance));
+
+	// A ray along an edge, parallel to two slabs at once.
+	check(CastRay(box, { 1.0f, 1.0f, -3.0f }, { 0.0f, 0.0f, 1.0f }, 100.0f, distance) && distance == 3.0f);
+}
+
+int main()
+{
+	TestSweep();
+	TestSweepNearMisses();
+	TestIntersectsRay();
+
+	return TestHelpers::Finish("AABBTests");
+}
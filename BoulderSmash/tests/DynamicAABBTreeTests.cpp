@@ -0,0 +1,335 @@
+#include "TestHelpers.hpp"
+#include <cmath>
+#include <random>
+#include <set>
+#include "physics/DynamicAABBTree.hpp"
+
+typedef std::set<std::int32_t> ProxySet;
+
+AABB RandomBox(std::mt19937& random, float worldSize, float maxSize)
+{
+	std::uniform_real_distribution<float> position(-worldSize * 0.5f, worldSize * 0.5f);
+	std::uniform_real_distribution<float> size(0.1f, maxSize);
+
+	glm::vec3 min{ position(random), position(random), position(random) };
+
+	return AABB::Register(min, min + glm::vec3{ size(random), size(random), size(random) });
+}
+
+// Walks the whole tree checking the links, heights and bounds; returns the number of leaves.
+// Balance is checked on the height as a whole: a leaf paired with a tall sibling can leave one node lopsided that a single rotation only partly repairs.
+std::size_t Validate(const DynamicAABBTree& tree, std::int32_t node, std::int32_t parent)
+{
+	if (node == nullNode)
+		return 0;
+
+	const AABBTreeNode& current = tree.GetNode(node);
+
+	check(current.parent == parent);
+
+	if (current.IsLeaf())
+	{
+		check(current.height == 0);
+		return 1;
+	}
+
+	const AABBTreeNode& child1 = tree.GetNode(current.child1);
+	const AABBTreeNode& child2 = tree.GetNode(current.child2);
+
+	check(current.height == 1 + std::max(child1.height, child2.height));
+	check(current.bounds.Contains(child1.bounds) && current.bounds.Contains(child2.bounds));
+
+	return Validate(tree, current.child1, node) + Validate(tree, current.child2, node);
+}
+
+ProxySet GetProxies(const DynamicAABBTree& tree)
+{
+	ProxySet proxies;
+
+	tree.ForEachProxy([&](std::int32_t proxy) { proxies.insert(proxy); });
+
+	return proxies;
+}
+
+ProxySet QueryByTree(const DynamicAABBTree& tree, const AABB& bounds)
+{
+	ProxySet found;
+
+	tree.Query(bounds, [&](std::int32_t proxy)
+	{
+		// The tree must not report a leaf twice.
+		check(found.insert(proxy).second);
+		return true;
+	});
+
+	return found;
+}
+
+ProxySet QueryByLoop(const DynamicAABBTree& tree, const ProxySet& proxies, const AABB& bounds)
+{
+	ProxySet found;
+
+	for (std::int32_t proxy : proxies)
+	{
+		if (tree.GetFatBounds(proxy).Overlaps(bounds))
+			found.insert(proxy);
+	}
+
+	return found;
+}
+
+void TestInsertRemoveMove()
+{
+	std::mt19937 random(21);
+	DynamicAABBTree tree;
+	ProxySet live;
+
+	check(tree.GetRoot() == nullNode && tree.GetHeight() == 0);
+
+	AABB first = AABB::Register(glm::vec3{ 0.0f }, glm::vec3{ 1.0f });
+	std::int32_t proxy = tree.CreateProxy(first, 7, 3);
+
+	check(tree.GetRoot() == proxy);
+	check(tree.GetEntity(proxy) == 7 && tree.GetIndex(proxy) == 3);
+	check(tree.GetFatBounds(proxy).min == glm::vec3{ -tree.margin } && tree.GetFatBounds(proxy).max == glm::vec3{ 1.0f + tree.margin });
+
+	// Moving inside the fat box leaves the tree alone.
+	check(!tree.MoveProxy(proxy, AABB::Register(glm::vec3{ 0.3f }, glm::vec3{ 1.3f }), glm::vec3{ 0.3f }));
+	check(tree.GetFatBounds(proxy).max == glm::vec3{ 1.0f + tree.margin });
+
+	// Leaving it reinserts the proxy with a box stretched along the displacement, and only that way.
+	AABB moved = AABB::Register(glm::vec3{ 2.0f, 0.0f, 0.0f }, glm::vec3{ 3.0f, 1.0f, 1.0f });
+
+	check(tree.MoveProxy(proxy, moved, glm::vec3{ 2.0f, 0.0f, 0.0f }));
+	check(tree.GetFatBounds(proxy).Contains(moved));
+	check(std::abs(tree.GetFatBounds(proxy).max.x - (3.0f + tree.margin + 2.0f * tree.displacementMultiplier)) < 1e-5f);
+	check(tree.GetFatBounds(proxy).min.x == 2.0f - tree.margin);
+	check(tree.GetFatBounds(proxy).max.y == 1.0f + tree.margin);
+
+	tree.DestroyProxy(proxy);
+
+	check(tree.GetRoot() == nullNode && GetProxies(tree).empty());
+
+	// Random churn: every step keeps the tree valid and holding exactly the live proxies, and freed nodes are reused.
+	for (int step = 0; step < 4000; ++step)
+	{
+		int action = static_cast<int>(random() % 3);
+
+		if (live.empty() || action == 0)
+			live.insert(tree.CreateProxy(RandomBox(random, 100.0f, 4.0f), static_cast<EntityID>(step), 0));
+		else if (action == 1)
+		{
+			auto victim = live.begin();
+
+			std::advance(victim, random() % live.size());
+			tree.DestroyProxy(*victim);
+			live.erase(victim);
+		}
+		else
+		{
+			auto mover = live.begin();
+
+			std::advance(mover, random() % live.size());
+
+			AABB bounds = RandomBox(random, 100.0f, 4.0f);
+
+			tree.MoveProxy(*mover, bounds, glm::vec3{ 1.0f });
+			check(tree.GetFatBounds(*mover).Contains(bounds));
+		}
+
+		if (step % 100 == 0)
+		{
+			check(Validate(tree, tree.GetRoot(), nullNode) == live.size());
+			check(GetProxies(tree) == live);
+		}
+	}
+
+	check(Validate(tree, tree.GetRoot(), nullNode) == live.size());
+
+	for (std::int32_t proxy : live)
+		tree.DestroyProxy(proxy);
+
+	check(tree.GetRoot() == nullNode);
+}
+
+// A box inserted next to one of two far-apart clusters must be paired inside that cluster, never with the far one or at the root.
+void TestSurfaceAreaPlacement()
+{
+	DynamicAABBTree tree;
+	std::vector<std::int32_t> left;
+	std::vector<std::int32_t> right;
+
+	tree.margin = 0.0f;
+
+	// Interleaved, so insertion order alone would mix the clusters.
+	for (int i = 0; i < 16; ++i)
+	{
+		left.push_back(tree.CreateProxy(AABB::Register(glm::vec3{ static_cast<float>(i % 4), static_cast<float>(i / 4), 0.0f }, glm::vec3{ static_cast<float>(i % 4) + 0.5f, static_cast<float>(i / 4) + 0.5f, 0.5f }), 0, 0));
+		right.push_back(tree.CreateProxy(AABB::Register(glm::vec3{ 1000.0f + i % 4, static_cast<float>(i / 4), 0.0f }, glm::vec3{ 1000.5f + i % 4, static_cast<float>(i / 4) + 0.5f, 0.5f }), 0, 0));
+	}
+
+	const AABBTreeNode& root = tree.GetNode(tree.GetRoot());
+	AABB leftBounds = AABB::Register(glm::vec3{ 0.0f }, glm::vec3{ 3.5f, 3.5f, 0.5f });
+	AABB rightBounds = AABB::Register(glm::vec3{ 1000.0f, 0.0f, 0.0f }, glm::vec3{ 1003.5f, 3.5f, 0.5f });
+
+	// The root splits the clusters cleanly: each child covers one of them and nothing else.
+	const AABB& child1 = tree.GetNode(root.child1).bounds;
+	const AABB& child2 = tree.GetNode(root.child2).bounds;
+
+	check((child1.Contains(leftBounds) && rightBounds.Contains(child2)) || (child2.Contains(leftBounds) && rightBounds.Contains(child1)));
+	check(!child1.Overlaps(child2));
+
+	// The new box sits beside the left cluster, touching only the corner leaf at (3, 3).
+	std::int32_t added = tree.CreateProxy(AABB::Register(glm::vec3{ 4.0f, 3.0f, 0.0f }, glm::vec3{ 4.5f, 3.5f, 0.5f }), 0, 0);
+	std::int32_t parent = tree.GetNode(added).parent;
+
+	check(parent != tree.GetRoot());
+	check(tree.GetNode(parent).bounds.max.x < 10.0f);
+
+	// Its new parent is small, not the whole cluster: the cheaper spot is low in the tree.
+	check(tree.GetNode(parent).bounds.GetSurfaceArea() < leftBounds.GetSurfaceArea());
+	check(Validate(tree, tree.GetRoot(), nullNode) == 33);
+}
+
+// Boxes inserted in sorted order along a line are the worst case for an unbalanced tree, which would degenerate into a list.
+void TestHeightStaysLogarithmic()
+{
+	DynamicAABBTree tree;
+	std::mt19937 random(8);
+	std::vector<std::int32_t> proxies;
+
+	for (int i = 0; i < 20000; ++i)
+		proxies.push_back(tree.CreateProxy(AABB::Register(glm::vec3{ static_cast<float>(i), 0.0f, 0.0f }, glm::vec3{ i + 0.5f, 0.5f, 0.5f }), 0, 0));
+
+	// An AVL tree over n leaves is at most about 1.44 log2(n) tall; rotating on the way back up after every change keeps this one within that.
+	double bound = 1.44 * std::log2(static_cast<double>(proxies.size())) + 2.0;
+
+	std::printf("Sorted insertion of %zu boxes: height %d, log2(n) %.1f\n", proxies.size(), tree.GetHeight(), std::log2(static_cast<double>(proxies.size())));
+
+	check(tree.GetHeight() <= bound);
+	check(Validate(tree, tree.GetRoot(), nullNode) == proxies.size());
+
+	// Removing every other box from one end must keep it balanced too.
+	for (std::size_t i = 0; i < proxies.size(); i += 2)
+		tree.DestroyProxy(proxies[i]);
+
+	check(tree.GetHeight() <= 1.44 * std::log2(proxies.size() / 2.0) + 2.0);
+	check(Validate(tree, tree.GetRoot(), nullNode) == proxies.size() / 2);
+
+	// Random boxes in random order.
+	DynamicAABBTree scattered;
+
+	for (int i = 0; i < 20000; ++i)
+		scattered.CreateProxy(RandomBox(random, 500.0f, 4.0f), 0, 0);
+
+	std::printf("Random insertion of 20000 boxes: height %d\n", scattered.GetHeight());
+
+	check(scattered.GetHeight() <= bound);
+	check(Validate(scattered, scattered.GetRoot(), nullNode) == 20000);
+}
+
+void TestQueriesMatchLoop()
+{
+	std::mt19937 random(33);
+	DynamicAABBTree tree;
+
+	for (int i = 0; i < 3000; ++i)
+		tree.CreateProxy(RandomBox(random, 200.0f, 6.0f), static_cast<EntityID>(i), i);
+
+	// Leave holes in the node array, so the results cannot rely on proxies being dense.
+	ProxySet proxies = GetProxies(tree);
+
+	for (std::int32_t proxy : std::vector<std::int32_t>(proxies.begin(), proxies.end()))
+	{
+		if (proxy % 3 == 0)
+			tree.DestroyProxy(proxy);
+	}
+
+	proxies = GetProxies(tree);
+
+	for (int q = 0; q < 200; ++q)
+	{
+		AABB bounds = RandomBox(random, 200.0f, 40.0f);
+
+		check(QueryByTree(tree, bounds) == QueryByLoop(tree, proxies, bounds));
+	}
+
+	// Returning false stops the query at the first leaf.
+	int calls = 0;
+
+	tree.Query(AABB::Register(glm::vec3{ -100.0f }, glm::vec3{ 100.0f }), [&](std::int32_t) { calls++; return false; });
+	check(calls == 1);
+
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+	for (int r = 0; r < 200; ++r)
+	{
+		glm::vec3 origin{ unit(random) * 120.0f, unit(random) * 120.0f, unit(random) * 120.0f };
+		glm::vec3 direction = glm::normalize(glm::vec3{ unit(random), unit(random), unit(random) });
+		glm::vec3 inverseDirection = 1.0f / direction;
+		float maxDistance = 150.0f;
+
+		// Every leaf the ray reaches, with the ray left unclipped.
+		ProxySet reached;
+
+		tree.RayCast(origin, direction, maxDistance, [&](std::int32_t proxy, float distance)
+		{
+			check(reached.insert(proxy).second);
+			return distance;
+		});
+
+		ProxySet expected;
+		std::int32_t nearest = nullNode;
+		float nearestDistance = maxDistance;
+
+		for (std::int32_t proxy : proxies)
+		{
+			float distance;
+
+			if (!tree.GetFatBounds(proxy).IntersectsRay(origin, inverseDirection, maxDistance, distance))
+				continue;
+
+			expected.insert(proxy);
+
+			if (distance < nearestDistance)
+			{
+				nearestDistance = distance;
+				nearest = proxy;
+			}
+		}
+
+		check(reached == expected);
+
+		// Clipping the ray at each hit finds the nearest leaf, as a closest-hit cast does.
+		std::int32_t closest = nullNode;
+		float closestDistance = maxDistance;
+
+		tree.RayCast(origin, direction, maxDistance, [&](std::int32_t proxy, float distance)
+		{
+			float entry;
+
+			tree.GetFatBounds(proxy).IntersectsRay(origin, inverseDirection, distance, entry);
+
+			if (entry < closestDistance)
+			{
+				closestDistance = entry;
+				closest = proxy;
+			}
+
+			return entry;
+		});
+
+		check(closest == nearest);
+		check(closestDistance == nearestDistance);
+	}
+}
+
+int main()
+{
+	TestInsertRemoveMove();
+	TestSurfaceAreaPlacement();
+	TestHeightStaysLogarithmic();
+	TestQueriesMatchLoop();
+
+	return TestHelpers::Finish("DynamicAABBTreeTests");
+}
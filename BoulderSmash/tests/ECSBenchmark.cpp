@@ -0,0 +1,124 @@
+#include "TestHelpers.hpp"
+#include <array>
+#include <cstdlib>
+#include <memory>
+#include "core/ECS.hpp"
+
+struct Position : Component
+{
+	glm::vec3 value{ 0.0f };
+};
+
+struct Velocity : Component
+{
+	glm::vec3 value{ 1.0f, 0.0f, 0.0f };
+};
+
+struct Damping : Component
+{
+	float value = 0.99f;
+};
+
+// The layout the archetype columns replaced: every component its own heap object, reached through a per-object pointer table.
+struct LegacyObject
+{
+	template<typename T>
+	T& Add(std::size_t slot)
+	{
+		components.emplace_back(std::make_unique<T>());
+		table[slot] = components.back().get();
+
+		return static_cast<T&>(*components.back());
+	}
+
+	template<typename T>
+	T& Get(std::size_t slot)
+	{
+		return *static_cast<T*>(table[slot]);
+	}
+
+	std::vector<std::unique_ptr<Component>> components;
+	std::array<Component*, 32> table{};
+};
+
+int main(int argc, char** argv)
+{
+	std::size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+
+	std::vector<std::unique_ptr<LegacyObject>> legacy;
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		legacy.emplace_back(std::make_unique<LegacyObject>());
+		legacy.back()->Add<Position>(0);
+		legacy.back()->Add<Velocity>(1);
+		legacy.back()->Add<Damping>(2);
+
+		GameObject& gameObject = ECSManager::AddGameObject();
+
+		gameObject.AddComponent<Position>();
+		gameObject.AddComponent<Velocity>();
+		gameObject.AddComponent<Damping>();
+	}
+
+	double before[3] =
+	{
+		TestHelpers::Measure([&]()
+		{
+			for (auto& object : legacy)
+				object->Get<Position>(0).value.x += 1.0f;
+		}),
+		TestHelpers::Measure([&]()
+		{
+			for (auto& object : legacy)
+				object->Get<Position>(0).value += object->Get<Velocity>(1).value;
+		}),
+		TestHelpers::Measure([&]()
+		{
+			for (auto& object : legacy)
+			{
+				Velocity& velocity = object->Get<Velocity>(1);
+
+				velocity.value *= object->Get<Damping>(2).value;
+				object->Get<Position>(0).value += velocity.value;
+			}
+		})
+	};
+
+	double after[3] =
+	{
+		TestHelpers::Measure([]()
+		{
+			ECSManager::ForEach<Position>([](Position& position) { position.value.x += 1.0f; });
+		}),
+		TestHelpers::Measure([]()
+		{
+			ECSManager::ForEach<Position, Velocity>([](Position& position, Velocity& velocity) { position.value += velocity.value; });
+		}),
+		TestHelpers::Measure([]()
+		{
+			ECSManager::ForEach<Position, Velocity, Damping>([](Position& position, Velocity& velocity, Damping& damping)
+			{
+				velocity.value *= damping.value;
+				position.value += velocity.value;
+			});
+		})
+	};
+
+	std::printf("Iterating %zu entities (best of 5, ms): heap components vs archetype columns\n", count);
+
+	for (int c = 0; c < 3; ++c)
+		std::printf("  %d component%s: %8.3f vs %8.3f (%.1fx)\n", c + 1, c == 0 ? " " : "s", before[c], after[c], before[c] / after[c]);
+
+	// Keeps the optimizer from dropping the loops.
+	float sink = 0.0f;
+
+	ECSManager::ForEach<Position>([&](Position& position) { sink += position.value.x; });
+
+	for (auto& object : legacy)
+		sink += object->Get<Position>(0).value.x;
+
+	std::printf("  (checksum %g)\n", sink);
+
+	return 0;
+}
@@ -0,0 +1,440 @@
+#include "TestHelpers.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include "core/ECS.hpp"
+
+struct Health : Component
+{
+	Health(int value = 0) : value(value) { }
+
+	int value;
+	std::string name = "health";
+};
+
+struct Speed : Component
+{
+	Speed(float value = 0.0f) : value(value) { }
+
+	float value;
+};
+
+struct Armor : Component
+{
+	int value = 7;
+};
+
+struct Ticks : Component
+{
+	void Update() override
+	{
+		count++;
+	}
+
+	int count = 0;
+};
+
+// Makes a structural change from inside Update, as gameplay components do: gaining a component, destroying another entity, or spawning one.
+struct Mutator : Component
+{
+	Mutator(int mode = 0, EntityID victim = nullEntity) : mode(mode), victim(victim) { }
+
+	void Update() override
+	{
+		count++;
+
+		if (mode == 0)
+			gameObject->AddComponent<Armor>();
+		else if (mode == 1)
+			ECSManager::DestroyGameObject(victim);
+		else if (mode == 3)
+			ECSManager::AddGameObject().AddComponent<Ticks>();
+	}
+
+	int mode;
+	EntityID victim;
+	int count = 0;
+};
+
+template<int N>
+struct Tag : Component
+{
+	char padding[N + 1];
+};
+
+// Each entity carries its own index in every component, so a row that was moved to the wrong place shows up as a mismatch.
+void CheckEntity(GameObject& gameObject, int index)
+{
+	check(gameObject.GetComponent<Health>().value == index);
+	check(gameObject.GetComponent<Health>().name == "health");
+	check(gameObject.GetComponent<Health>().gameObject == &gameObject);
+
+	if (gameObject.HasComponent<Speed>())
+	{
+		check(gameObject.GetComponent<Speed>().value == static_cast<float>(index));
+		check(gameObject.GetComponent<Speed>().gameObject == &gameObject);
+	}
+}
+
+void TestColumns()
+{
+	std::vector<EntityID> ids;
+
+	for (int i = 0; i < 64; ++i)
+	{
+		GameObject& gameObject = ECSManager::AddGameObject();
+
+		gameObject.AddComponent<Health>(i);
+		gameObject.AddComponent<Speed>(static_cast<float>(i));
+
+		ids.push_back(gameObject.GetID());
+	}
+
+	check(ECSManager::Query<Health, Speed>().Size() == 64);
+
+	// Migrating the first row out of the Health+Speed archetype swap-removes the last row into it.
+	ECSManager::GetGameObject(ids[0])->AddComponent<Armor>();
+
+	check(ECSManager::Query<Health, Speed>().Size() == 64);
+	check(ECSManager::Query<Armor>().Size() == 1);
+
+	for (int i = 0; i < 64; ++i)
+		CheckEntity(*ECSManager::GetGameObject(ids[i]), i);
+
+	check(ECSManager::GetGameObject(ids[0])->GetComponent<Armor>().value == 7);
+
+	// Removing a component from a middle row moves that entity back and pulls another row into the hole.
+	for (int i = 10; i < 20; ++i)
+		ECSManager::GetGameObject(ids[i])->RemoveComponent<Speed>();
+
+	check(ECSManager::Query<Health, Speed>().Size() == 54);
+	check(ECSManager::Query<Health>().Size() == 64);
+
+	for (int i = 0; i < 64; ++i)
+	{
+		check(ECSManager::GetGameObject(ids[i])->HasComponent<Speed>() == (i < 10 || i >= 20));
+		CheckEntity(*ECSManager::GetGameObject(ids[i]), i);
+	}
+
+	// Replacing an existing component keeps the entity in place.
+	ECSManager::GetGameObject(ids[30])->AddComponent<Health>(30);
+	CheckEntity(*ECSManager::GetGameObject(ids[30]), 30);
+
+	for (int i = 0; i < 64; i += 3)
+		ECSManager::DestroyGameObject(ids[i]);
+
+	for (int i = 0; i < 64; ++i)
+	{
+		if (i % 3 == 0)
+			check(!ECSManager::GetGameObject(ids[i]));
+		else
+			CheckEntity(*ECSManager::GetGameObject(ids[i]), i);
+	}
+
+	int sum = 0;
+	int expected = 0;
+
+	ECSManager::ForEach<Health>([&](Health& health) { sum += health.value; });
+
+	for (int i = 0; i < 64; ++i)
+		expected += i % 3 == 0 ? 0 : i;
+
+	check(sum == expected);
+
+	for (int i = 0; i < 64; ++i)
+		ECSManager::DestroyGameObject(ids[i]);
+
+	check(ECSManager::GetGameObjects().empty());
+	check(ECSManager::Query<Health>().Size() == 0);
+}
+
+void TestGenerations()
+{
+	EntityID first = ECSManager::AddGameObject().GetID();
+	std::uint32_t index = GetEntityIndex(first);
+	EntityID last = first;
+
+	ECSManager::DestroyGameObject(first);
+
+	// The freed index is handed out again with the next generation until its generations run out.
+	for (std::uint32_t generation = GetEntityGeneration(first) + 1; generation < entityGenerationMask; ++generation)
+	{
+		EntityID id = ECSManager::AddGameObject().GetID();
+
+		check(GetEntityIndex(id) == index);
+		check(GetEntityGeneration(id) == generation);
+		check(!ECSManager::IsValid(last));
+
+		ECSManager::DestroyGameObject(id);
+		last = id;
+	}
+
+	EntityID next = ECSManager::AddGameObject().GetID();
+
+	check(GetEntityIndex(next) != index);
+	check(!ECSManager::IsValid(first));
+	check(!ECSManager::IsValid(last));
+	check(!ECSManager::IsValid(nullEntity));
+
+	ECSManager::DestroyGameObject(next);
+}
+
+// Runs in a child process (ECSTests exhaust), since running out of indices ends the process. Returns 0 only when something is wrong.
+int ExhaustIndices()
+{
+	EntityID last = nullEntity;
+
+	for (std::uint32_t i = 0; i <= entityIndexMask; ++i)
+		last = ECSManager::AddGameObject().GetID();
+
+	std::uint32_t index = 0;
+
+	check(GetEntityIndex(last) == entityIndexMask && GetEntityGeneration(last) == 0);
+	check(!ECSManager::AllocateEntityIndex(index));
+	check(!ECSManager::AllocateEntityIndex(index));
+	check(ECSManager::IsValid(last));
+
+	if (TestHelpers::failures > 0)
+		return 0;
+
+	// The fatal error exits inside this call; the fatal message box would wait for a click on Windows, so the call is left out there.
+#ifndef _WIN32
+	ECSManager::AddGameObject();
+	std::printf("AddGameObject returned after running out of indices\n");
+
+	return 0;
+#else
+	return 1;
+#endif
+}
+
+void TestIndexExhaustion(const char* program)
+{
+	check(std::system((std::string("\"") + program + "\" exhaust").c_str()) != 0);
+}
+
+// Every component that existed when the tick started is updated exactly once, however the columns are reshuffled under the loop.
+void TestStructuralChangesDuringUpdate()
+{
+	std::vector<EntityID> ids(200);
+
+	for (int i = 199; i >= 0; --i)
+	{
+		GameObject& gameObject = ECSManager::AddGameObject();
+
+		gameObject.AddComponent<Ticks>();
+		gameObject.AddComponent<Mutator>(i % 4, i % 4 == 1 ? ids[i + 1] : nullEntity);
+
+		ids[i] = gameObject.GetID();
+	}
+
+	ECSManager::UpdateGameObjects();
+
+	check(ECSManager::GetGameObjects().size() == 200 - 50 + 50);
+
+	for (int i = 0; i < 200; ++i)
+	{
+		GameObject* gameObject = ECSManager::GetGameObject(ids[i]);
+
+		check((gameObject == nullptr) == (i % 4 == 2));
+
+		if (!gameObject)
+			continue;
+
+		check(gameObject->GetComponent<Ticks>().count == 1);
+		check(gameObject->GetComponent<Mutator>().count == 1);
+		check(gameObject->HasComponent<Armor>() == (i % 4 == 0));
+	}
+
+	int spawned = 0;
+
+	ECSManager::ForEach<Ticks>([&](Ticks& ticks)
+	{
+		if (!ticks.gameObject->HasComponent<Mutator>())
+		{
+			spawned++;
+			check(ticks.count == 0);
+		}
+	});
+
+	check(spawned == 50);
+
+	std::vector<EntityID> remaining;
+
+	for (GameObject* gameObject : ECSManager::GetGameObjects())
+		remaining.push_back(gameObject->GetID());
+
+	for (EntityID id : remaining)
+		ECSManager::DestroyGameObject(id);
+}
+
+template<int First, int... Ns>
+void RegisterTags(std::integer_sequence<int, Ns...>, std::vector<ComponentID>& ids)
+{
+	(ids.push_back(GetComponentTypeID<Tag<First + Ns>>()), ...);
+}
+
+// Eight threads meet fresh component types at the same moment, as systems doing their first EntityCommandBuffer::AddComponent would.
+void TestConcurrentRegistration()
+{
+	std::atomic<bool> go = false;
+	std::vector<ComponentID> ids[8];
+	std::vector<std::thread> threads;
+
+	auto start = [&](int t, auto registerTags)
+	{
+		threads.emplace_back([&, t, registerTags]()
+		{
+			while (!go)
+				std::this_thread::yield();
+
+			registerTags(ids[t]);
+		});
+	};
+
+	start(0, [](std::vector<ComponentID>& ids) { RegisterTags<0>(std::make_integer_sequence<int, 16>{}, ids); });
+	start(1, [](std::vector<ComponentID>& ids) { RegisterTags<16>(std::make_integer_sequence<int, 16>{}, ids); });
+	start(2, [](std::vector<ComponentID>& ids) { RegisterTags<32>(std::make_integer_sequence<int, 16>{}, ids); });
+	start(3, [](std::vector<ComponentID>& ids) { RegisterTags<48>(std::make_integer_sequence<int, 16>{}, ids); });
+	start(4, [](std::vector<ComponentID>& ids) { RegisterTags<64>(std::make_integer_sequence<int, 16>{}, ids); });
+	start(5, [](std::vector<ComponentID>& ids) { RegisterTags<80>(std::make_integer_sequence<int, 16>{}, ids); });
+	start(6, [](std::vector<ComponentID>& ids) { RegisterTags<0>(std::make_integer_sequence<int, 16>{}, ids); });
+	start(7, [](std::vector<ComponentID>& ids) { RegisterTags<48>(std::make_integer_sequence<int, 16>{}, ids); });
+
+	go = true;
+
+	for (auto& thread : threads)
+		thread.join();
+
+	std::set<ComponentID> unique;
+
+	for (int t = 0; t < 6; ++t)
+		unique.insert(ids[t].begin(), ids[t].end());
+
+	check(unique.size() == 96);
+	check(ids[6] == ids[0]);
+	check(ids[7] == ids[3]);
+
+	for (ComponentID id : unique)
+	{
+		check(id < componentTypeInfos.size());
+		check(GetComponentTypeIDFromHash(componentTypeInfos[id].hash) == id);
+	}
+
+	check(componentTypeInfos[ids[5][15]].size == sizeof(Tag<95>));
+}
+
+// Two system chunks record on two threads; whichever thread claims its command buffer first, playback must come out the same.
+std::vector<int> PlaybackFromThreads(bool swapped)
+{
+	EntityID shared = ECSManager::AddGameObject().GetID();
+	std::size_t first = ECSManager::GetGameObjects().size();
+
+	auto record = [shared](std::uint32_t chunk)
+	{
+		std::thread thread([shared, chunk]()
+		{
+			EntityCommandBuffer& buffer = ECSManager::GetCommandBuffer();
+
+			CommandOrigin::GetCurrent() = { chunk, 0 };
+
+			for (int i = 0; i < 3; ++i)
+				buffer.AddComponent<Health>(buffer.Spawn(), static_cast<int>(chunk * 10 + i));
+
+			buffer.AddComponent<Speed>(shared, static_cast<float>(chunk));
+		});
+
+		thread.join();
+	};
+
+	record(swapped ? 2 : 1);
+	record(swapped ? 1 : 2);
+
+	ECSManager::PlaybackCommandBuffers();
+
+	std::vector<int> result;
+
+	for (std::size_t g = first; g < ECSManager::GetGameObjects().size(); ++g)
+		result.push_back(ECSManager::GetGameObjects()[g]->GetComponent<Health>().value);
+
+	result.push_back(static_cast<int>(ECSManager::GetGameObject(shared)->GetComponent<Speed>().value));
+
+	std::vector<EntityID> ids;
+
+	for (std::size_t g = first - 1; g < ECSManager::GetGameObjects().size(); ++g)
+		ids.push_back(ECSManager::GetGameObjects()[g]->GetID());
+
+	for (EntityID id : ids)
+		ECSManager::DestroyGameObject(id);
+
+	return result;
+}
+
+void TestPlaybackOrder()
+{
+	std::vector<int> expected = { 10, 11, 12, 20, 21, 22, 2 };
+
+	check(PlaybackFromThreads(false) == expected);
+	check(PlaybackFromThreads(true) == expected);
+}
+
+// Short-lived threads must not leave their buffers behind, but what they recorded before exiting is still played back.
+void TestThreadsReleaseBuffers()
+{
+	std::size_t buffers = ECSManager::GetCommandBufferCount();
+	std::size_t first = ECSManager::GetGameObjects().size();
+
+	for (int i = 0; i < 100; ++i)
+	{
+		std::thread thread([i]()
+		{
+			EntityCommandBuffer& buffer = ECSManager::GetCommandBuffer();
+
+			if (i % 10 == 0)
+				buffer.AddComponent<Health>(buffer.Spawn(), i);
+		});
+
+		thread.join();
+	}
+
+	check(ECSManager::GetCommandBufferCount() == buffers + 10);
+
+	ECSManager::PlaybackCommandBuffers();
+
+	check(ECSManager::GetCommandBufferCount() == buffers);
+	check(ECSManager::GetGameObjects().size() == first + 10);
+
+	std::vector<EntityID> ids;
+
+	for (std::size_t g = first; g < ECSManager::GetGameObjects().size(); ++g)
+	{
+		check(ECSManager::GetGameObjects()[g]->GetComponent<Health>().value % 10 == 0);
+		ids.push_back(ECSManager::GetGameObjects()[g]->GetID());
+	}
+
+	for (EntityID id : ids)
+		ECSManager::DestroyGameObject(id);
+
+	ECSManager::PlaybackCommandBuffers();
+
+	check(ECSManager::GetCommandBufferCount() == buffers);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1 && std::string(argv[1]) == "exhaust")
+		return ExhaustIndices();
+
+	TestColumns();
+	TestGenerations();
+	TestIndexExhaustion(argv[0]);
+	TestStructuralChangesDuringUpdate();
+	TestConcurrentRegistration();
+	TestPlaybackOrder();
+	TestThreadsReleaseBuffers();
+
+	return TestHelpers::Finish("ECSTests");
+}
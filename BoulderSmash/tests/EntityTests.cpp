@@ -0,0 +1,68 @@
+#include "TestHelpers.hpp"
+#include <algorithm>
+#include "gameplay/Entity.hpp"
+
+struct EntityRock : public Entity
+{
+	void Start() override
+	{
+		EntityManager::RegisterEntity(*this);
+	}
+};
+
+// Asteroids spawn and break up for the whole session; the registry must stay as small as the live set, not grow with every spawn.
+void TestRegistryStaysBounded()
+{
+	std::vector<EntityID> alive;
+
+	for (int i = 0; i < 100; ++i)
+	{
+		GameObject& gameObject = ECSManager::AddGameObject();
+
+		gameObject.AddComponent<EntityRock>();
+		alive.push_back(gameObject.GetID());
+	}
+
+	std::size_t largest = 0;
+
+	for (int i = 0; i < 100000; ++i)
+	{
+		ECSManager::DestroyGameObject(alive[i % alive.size()]);
+
+		GameObject& gameObject = ECSManager::AddGameObject();
+
+		gameObject.AddComponent<EntityRock>();
+		alive[i % alive.size()] = gameObject.GetID();
+
+		largest = std::max(largest, EntityManager::registeredEntities.size());
+	}
+
+	check(largest <= 2 * alive.size() + 1);
+
+	EntityManager::RemoveStaleEntities();
+
+	// Reused slots come back with a new generation, so only the live IDs are left.
+	std::vector<EntityID> registered = EntityManager::registeredEntities;
+
+	std::sort(registered.begin(), registered.end());
+	std::sort(alive.begin(), alive.end());
+
+	check(registered == alive);
+
+	for (EntityID id : registered)
+		check(EntityManager::GetEntity<EntityRock>(id) != nullptr);
+
+	for (EntityID id : alive)
+		ECSManager::DestroyGameObject(id);
+
+	EntityManager::RemoveStaleEntities();
+
+	check(EntityManager::registeredEntities.empty());
+}
+
+int main()
+{
+	TestRegistryStaysBounded();
+
+	return TestHelpers::Finish("EntityTests");
+}
@@ -0,0 +1,184 @@
+#include "TestHelpers.hpp"
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include "core/Window.hpp"
+#include "audio/SoundManager.hpp"
+#include "rendering/FrameUniforms.hpp"
+
+// Compile together with glad.c from the repository root and link the libraries in Libraries/lib, as the game project does.
+// Only the buffer calls below are made, and they answer from fakes, so no window or context is needed.
+struct Upload
+{
+	unsigned int buffer;
+	std::size_t size;
+	GLenum usage;
+	std::vector<unsigned char> data;
+};
+
+std::vector<Upload> uploads;
+std::vector<unsigned int> bindingPoints;
+unsigned int boundUniformBuffer = 0;
+unsigned int nextBuffer = 7;
+int generated = 0;
+
+void APIENTRY FakeGenBuffers(GLsizei count, GLuint* buffers)
+{
+	for (GLsizei b = 0; b < count; ++b)
+		buffers[b] = nextBuffer++;
+
+	generated += count;
+}
+
+void APIENTRY FakeBindBuffer(GLenum target, GLuint buffer)
+{
+	if (target == GL_UNIFORM_BUFFER)
+		boundUniformBuffer = buffer;
+}
+
+void APIENTRY FakeBindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	if (target == GL_UNIFORM_BUFFER)
+	{
+		boundUniformBuffer = buffer;
+		bindingPoints.resize(std::max<std::size_t>(bindingPoints.size(), index + 1));
+		bindingPoints[index] = buffer;
+	}
+}
+
+void APIENTRY FakeBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+	if (target != GL_UNIFORM_BUFFER)
+		return;
+
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+	uploads.push_back({ boundUniformBuffer, static_cast<std::size_t>(size), usage, std::vector<unsigned char>(bytes, bytes + size) });
+}
+
+void InstallFakes()
+{
+	glad_glGenBuffers = FakeGenBuffers;
+	glad_glBindBuffer = FakeBindBuffer;
+	glad_glBindBufferBase = FakeBindBufferBase;
+	glad_glBufferData = FakeBufferData;
+}
+
+template<typename Type>
+Type Read(const Upload& upload, std::size_t offset)
+{
+	Type value;
+
+	std::memcpy(&value, upload.data.data() + offset, sizeof(Type));
+
+	return value;
+}
+
+// Offsets the std140 rules give the blocks as the shaders in assets/shaders declare them.
+void TestLayout()
+{
+	check(offsetof(CameraBlock, projection) == 0 && offsetof(CameraBlock, view) == 64 && offsetof(CameraBlock, viewPosition) == 128);
+
+	check(offsetof(DirectionalLightBlock, direction) == 0 && offsetof(DirectionalLightBlock, ambient) == 16);
+	check(offsetof(DirectionalLightBlock, diffuse) == 32 && offsetof(DirectionalLightBlock, specular) == 48);
+	check(sizeof(DirectionalLightBlock) == 64);
+
+	check(offsetof(PointLightBlock, position) == 0 && offsetof(PointLightBlock, constant) == 12);
+	check(offsetof(PointLightBlock, linear) == 16 && offsetof(PointLightBlock, quadratic) == 20);
+	check(offsetof(PointLightBlock, ambient) == 32 && offsetof(PointLightBlock, diffuse) == 48 && offsetof(PointLightBlock, specular) == 64);
+
+	check(offsetof(SpotLightBlock, position) == 0 && offsetof(SpotLightBlock, direction) == 16);
+	check(offsetof(SpotLightBlock, cutOff) == 28 && offsetof(SpotLightBlock, outerCutOff) == 32);
+	check(offsetof(SpotLightBlock, constant) == 36 && offsetof(SpotLightBlock, linear) == 40 && offsetof(SpotLightBlock, quadratic) == 44);
+	check(offsetof(SpotLightBlock, ambient) == 48 && offsetof(SpotLightBlock, diffuse) == 64 && offsetof(SpotLightBlock, specular) == 80);
+
+	// An array of structs strides by the struct's size rounded up to 16.
+	check(offsetof(LightsBlock, directionalLight) == 0 && offsetof(LightsBlock, pointLights) == 64);
+	check(offsetof(LightsBlock, spotLight) == 64 + 80 * maxPointLights);
+}
+
+std::shared_ptr<PointLight> MakeLight(float ambient)
+{
+	std::shared_ptr<PointLight> light = std::make_shared<PointLight>();
+
+	light->transform.position = glm::vec3{ ambient, 2.0f, 3.0f };
+	light->ambient = glm::vec3{ ambient };
+
+	return light;
+}
+
+void TestUpload()
+{
+	std::shared_ptr<Camera> camera = std::make_shared<Camera>();
+	std::shared_ptr<DirectionalLight> directionalLight = std::make_shared<DirectionalLight>();
+	std::vector<std::shared_ptr<PointLight>> lights;
+
+	camera->transform.position = glm::vec3{ 1.0f, 2.0f, 3.0f };
+
+	directionalLight->diffuse = glm::vec3{ 0.25f, 0.5f, 0.75f };
+
+	for (int l = 0; l < 6; ++l)
+		lights.push_back(MakeLight(0.1f * (l + 1)));
+
+	FrameUniforms::Update(camera, directionalLight, lights);
+
+	// The first frame creates both buffers and ties them to their binding points.
+	check(generated == 2 && uploads.size() == 2);
+	check(bindingPoints.size() == 2 && bindingPoints[cameraBlockBinding] == FrameUniforms::cameraBuffer && bindingPoints[lightsBlockBinding] == FrameUniforms::lightsBuffer);
+	check(FrameUniforms::cameraBuffer != FrameUniforms::lightsBuffer);
+
+	const Upload& cameraUpload = uploads[0];
+
+	check(cameraUpload.buffer == FrameUniforms::cameraBuffer && cameraUpload.size == 144 && cameraUpload.usage == GL_STREAM_DRAW);
+	check(Read<glm::mat4>(cameraUpload, 0) == camera->GetProjection().projection && Read<glm::mat4>(cameraUpload, 64) == camera->GetProjection().view);
+	check(Read<glm::vec3>(cameraUpload, 128) == glm::vec3(1.0f, 2.0f, 3.0f));
+
+	const Upload& lightsUpload = uploads[1];
+
+	check(lightsUpload.buffer == FrameUniforms::lightsBuffer && lightsUpload.size == 480);
+	check(Read<glm::vec3>(lightsUpload, 32) == glm::vec3(0.25f, 0.5f, 0.75f));
+
+	// Lights past maxPointLights are dropped.
+	for (int l = 0; l < maxPointLights; ++l)
+	{
+		std::size_t offset = 64 + 80 * l;
+
+		check(Read<glm::vec3>(lightsUpload, offset) == lights[l]->transform.position);
+		check(Read<float>(lightsUpload, offset + 12) == 1.0f);
+		check(Read<glm::vec3>(lightsUpload, offset + 32) == lights[l]->ambient);
+	}
+
+	check(Read<glm::vec3>(lightsUpload, 384) == glm::vec3(1.0f, 2.0f, 3.0f));
+	check(Read<float>(lightsUpload, 384 + 28) == glm::cos(glm::radians(12.5f)));
+	check(Read<glm::vec3>(lightsUpload, 384 + 80) == glm::vec3(1.0f));
+
+	// Later frames re-specify the same buffers and bind nothing new; unused point light slots are zeroed, which the shaders skip.
+	lights.resize(2);
+	uploads.clear();
+	bindingPoints.clear();
+
+	FrameUniforms::Update(camera, directionalLight, lights);
+
+	check(generated == 2 && bindingPoints.empty() && uploads.size() == 2);
+	check(uploads[0].buffer == FrameUniforms::cameraBuffer && uploads[1].buffer == FrameUniforms::lightsBuffer);
+	check(Read<glm::vec3>(uploads[1], 64 + 80) == lights[1]->transform.position);
+	check(Read<glm::vec3>(uploads[1], 64 + 80 * 2 + 32) == glm::vec3(0.0f) && Read<glm::vec3>(uploads[1], 64 + 80 * 3 + 32) == glm::vec3(0.0f));
+
+	// Without a directional light its slot stays zeroed.
+	uploads.clear();
+
+	FrameUniforms::Update(camera, nullptr, lights);
+
+	check(Read<glm::vec3>(uploads[1], 32) == glm::vec3(0.0f));
+}
+
+int main()
+{
+	InstallFakes();
+
+	TestLayout();
+	TestUpload();
+
+	return TestHelpers::Finish("FrameUniformsTests");
+}
@@ -0,0 +1,183 @@
+#include "TestHelpers.hpp"
+#include <string>
+#include <vector>
+#include "rendering/GLState.hpp"
+
+// Compile together with glad.c from the repository root. The GL entry points are pointed at the fakes below,
+// which only record the calls, so no window or context is needed.
+std::vector<std::string> calls;
+
+std::string Call(const char* name, unsigned int a, unsigned int b = 0, unsigned int c = 0)
+{
+	return std::string(name) + " " + std::to_string(a) + " " + std::to_string(b) + " " + std::to_string(c);
+}
+
+void Record(const char* name, unsigned int a, unsigned int b = 0, unsigned int c = 0)
+{
+	calls.push_back(Call(name, a, b, c));
+}
+
+void APIENTRY FakeUseProgram(GLuint program) { Record("UseProgram", program); }
+void APIENTRY FakeBindVertexArray(GLuint vertexArray) { Record("BindVertexArray", vertexArray); }
+void APIENTRY FakeBindBuffer(GLenum target, GLuint buffer) { Record("BindBuffer", target, buffer); }
+void APIENTRY FakeBindBufferBase(GLenum target, GLuint index, GLuint buffer) { Record("BindBufferBase", target, index, buffer); }
+void APIENTRY FakeDeleteBuffers(GLsizei count, const GLuint* buffers) { Record("DeleteBuffers", static_cast<unsigned int>(count), buffers[0]); }
+void APIENTRY FakeActiveTexture(GLenum unit) { Record("ActiveTexture", unit - GL_TEXTURE0); }
+void APIENTRY FakeBindTexture(GLenum target, GLuint texture) { Record("BindTexture", target, texture); }
+void APIENTRY FakeEnable(GLenum capability) { Record("Enable", capability); }
+void APIENTRY FakeDisable(GLenum capability) { Record("Disable", capability); }
+void APIENTRY FakeDepthFunc(GLenum function) { Record("DepthFunc", function); }
+void APIENTRY FakeDepthMask(GLboolean flag) { Record("DepthMask", flag); }
+void APIENTRY FakeBlendFunc(GLenum source, GLenum destination) { Record("BlendFunc", source, destination); }
+
+void InstallFakes()
+{
+	glad_glUseProgram = FakeUseProgram;
+	glad_glBindVertexArray = FakeBindVertexArray;
+	glad_glBindBuffer = FakeBindBuffer;
+	glad_glBindBufferBase = FakeBindBufferBase;
+	glad_glDeleteBuffers = FakeDeleteBuffers;
+	glad_glActiveTexture = FakeActiveTexture;
+	glad_glBindTexture = FakeBindTexture;
+	glad_glEnable = FakeEnable;
+	glad_glDisable = FakeDisable;
+	glad_glDepthFunc = FakeDepthFunc;
+	glad_glDepthMask = FakeDepthMask;
+	glad_glBlendFunc = FakeBlendFunc;
+}
+
+bool Issued(const std::vector<std::string>& expected)
+{
+	bool matches = calls == expected;
+
+	calls.clear();
+
+	return matches;
+}
+
+void TestBindingsAreFiltered()
+{
+	GLState::BeginFrame();
+	calls.clear();
+
+	check(GLState::UseProgram(3) && !GLState::UseProgram(3) && GLState::UseProgram(4) && GLState::UseProgram(3));
+	check(Issued({ Call("UseProgram", 3), Call("UseProgram", 4), Call("UseProgram", 3) }));
+
+	check(GLState::BindVertexArray(7) && !GLState::BindVertexArray(7) && GLState::BindVertexArray(0) && !GLState::BindVertexArray(0));
+	check(Issued({ Call("BindVertexArray", 7), Call("BindVertexArray", 0) }));
+
+	// Array and uniform buffer bindings are tracked apart; element array bindings belong to the VAO and always go through.
+	check(GLState::BindBuffer(GL_ARRAY_BUFFER, 5) && !GLState::BindBuffer(GL_ARRAY_BUFFER, 5));
+	check(GLState::BindBuffer(GL_UNIFORM_BUFFER, 5) && !GLState::BindBuffer(GL_UNIFORM_BUFFER, 5));
+	check(GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 5) && GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 5));
+	check(Issued({ Call("BindBuffer", GL_ARRAY_BUFFER, 5), Call("BindBuffer", GL_UNIFORM_BUFFER, 5), Call("BindBuffer", GL_ELEMENT_ARRAY_BUFFER, 5), Call("BindBuffer", GL_ELEMENT_ARRAY_BUFFER, 5) }));
+
+	// glBindBufferBase also sets the generic binding, so binding the same buffer next is redundant.
+	GLState::BindBufferBase(GL_UNIFORM_BUFFER, 1, 8);
+	check(!GLState::BindBuffer(GL_UNIFORM_BUFFER, 8) && GLState::BindBuffer(GL_UNIFORM_BUFFER, 5));
+	check(Issued({ Call("BindBufferBase", GL_UNIFORM_BUFFER, 1, 8), Call("BindBuffer", GL_UNIFORM_BUFFER, 5) }));
+
+	// A deleted buffer is unbound, and its name may come back from glGenBuffers, so binding it again must reach GL.
+	unsigned int buffer = 5;
+
+	GLState::DeleteBuffer(buffer);
+	check(buffer == 0);
+	check(GLState::BindBuffer(GL_ARRAY_BUFFER, 5) && GLState::BindBuffer(GL_UNIFORM_BUFFER, 5));
+	check(Issued({ Call("DeleteBuffers", 1, 5), Call("BindBuffer", GL_ARRAY_BUFFER, 5), Call("BindBuffer", GL_UNIFORM_BUFFER, 5) }));
+}
+
+void TestTexturesAreFiltered()
+{
+	GLState::BeginFrame();
+	calls.clear();
+
+	// The active unit switches only when a binding on another unit actually changes.
+	check(GLState::BindTexture(2, GL_TEXTURE_2D, 9) && !GLState::BindTexture(2, GL_TEXTURE_2D, 9));
+	check(GLState::BindTexture(2, GL_TEXTURE_CUBE_MAP, 9));
+	check(GLState::BindTexture(0, GL_TEXTURE_2D, 9) && !GLState::BindTexture(2, GL_TEXTURE_2D, 9));
+	check(GLState::BindTexture(2, GL_TEXTURE_2D, 4));
+	check(Issued({ Call("ActiveTexture", 2), Call("BindTexture", GL_TEXTURE_2D, 9), Call("BindTexture", GL_TEXTURE_CUBE_MAP, 9), Call("ActiveTexture", 0), Call("BindTexture", GL_TEXTURE_2D, 9), Call("ActiveTexture", 2), Call("BindTexture", GL_TEXTURE_2D, 4) }));
+
+	check(!GLState::ActiveTexture(2) && GLState::ActiveTexture(3));
+	check(Issued({ Call("ActiveTexture", 3) }));
+
+	// Units past the tracked ones and other targets are never filtered.
+	check(GLState::BindTexture(maxTrackedTextureUnits, GL_TEXTURE_2D, 1) && GLState::BindTexture(maxTrackedTextureUnits, GL_TEXTURE_2D, 1));
+	check(GLState::BindTexture(3, GL_TEXTURE_3D, 1) && GLState::BindTexture(3, GL_TEXTURE_3D, 1));
+	check(Issued({ Call("ActiveTexture", maxTrackedTextureUnits), Call("BindTexture", GL_TEXTURE_2D, 1), Call("BindTexture", GL_TEXTURE_2D, 1), Call("ActiveTexture", 3), Call("BindTexture", GL_TEXTURE_3D, 1), Call("BindTexture", GL_TEXTURE_3D, 1) }));
+}
+
+void TestFixedFunctionStateIsFiltered()
+{
+	GLState::BeginFrame();
+	calls.clear();
+
+	check(GLState::SetCapability(GL_CULL_FACE, false) && !GLState::SetCapability(GL_CULL_FACE, false) && GLState::SetCapability(GL_CULL_FACE, true));
+	check(GLState::SetCapability(GL_BLEND, true) && GLState::SetCapability(GL_DEPTH_TEST, true) && GLState::SetCapability(GL_STENCIL_TEST, false));
+	check(!GLState::SetCapability(GL_BLEND, true) && !GLState::SetCapability(GL_DEPTH_TEST, true) && !GLState::SetCapability(GL_STENCIL_TEST, false));
+
+	// Capabilities with no shadow always go through.
+	check(GLState::SetCapability(GL_MULTISAMPLE, true) && GLState::SetCapability(GL_MULTISAMPLE, true));
+	check(Issued({ Call("Disable", GL_CULL_FACE), Call("Enable", GL_CULL_FACE), Call("Enable", GL_BLEND), Call("Enable", GL_DEPTH_TEST), Call("Disable", GL_STENCIL_TEST), Call("Enable", GL_MULTISAMPLE), Call("Enable", GL_MULTISAMPLE) }));
+
+	check(GLState::DepthFunc(GL_LEQUAL) && !GLState::DepthFunc(GL_LEQUAL) && GLState::DepthFunc(GL_LESS));
+	check(GLState::DepthMask(false) && !GLState::DepthMask(false) && GLState::DepthMask(true));
+	check(GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA) && !GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA) && GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE));
+	check(Issued({ Call("DepthFunc", GL_LEQUAL), Call("DepthFunc", GL_LESS), Call("DepthMask", GL_FALSE), Call("DepthMask", GL_TRUE), Call("BlendFunc", GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA), Call("BlendFunc", GL_SRC_ALPHA, GL_ONE) }));
+}
+
+// BeginFrame forgets the shadow, so state changed behind its back between frames is set again, and hands over the frame's counters.
+void TestFrames()
+{
+	GLState::BeginFrame();
+	calls.clear();
+
+	// The first call of each kind in a frame is issued, even one setting a texture unit back to 0.
+	check(GLState::UseProgram(3) && GLState::BindTexture(0, GL_TEXTURE_2D, 0) && GLState::SetCapability(GL_CULL_FACE, true));
+	check(!GLState::UseProgram(3) && !GLState::BindTexture(0, GL_TEXTURE_2D, 0) && !GLState::SetCapability(GL_CULL_FACE, true));
+
+	GLState::BeginFrame();
+
+	check(GLState::GetLastFrameCounters().issued == 4 && GLState::GetLastFrameCounters().filtered == 3);
+	check(GLState::UseProgram(3) && GLState::BindTexture(0, GL_TEXTURE_2D, 0) && GLState::SetCapability(GL_CULL_FACE, true));
+	check(calls.size() == 8);
+
+	// A frame drawing the same thing many times, with the skybox's toggles at the end: only the first of each call survives.
+	for (int f = 0; f < 3; ++f)
+	{
+		GLState::BeginFrame();
+		calls.clear();
+
+		for (int o = 0; o < 100; ++o)
+		{
+			GLState::UseProgram(1 + o / 50);
+			GLState::BindTexture(0, GL_TEXTURE_2D, 10);
+			GLState::BindTexture(1, GL_TEXTURE_2D, 11);
+			GLState::BindVertexArray(20);
+		}
+
+		GLState::DepthFunc(GL_LEQUAL);
+		GLState::SetCapability(GL_CULL_FACE, false);
+		GLState::DepthFunc(GL_LESS);
+		GLState::SetCapability(GL_CULL_FACE, true);
+
+		GLState::BeginFrame();
+
+		const GLStateCounters& counters = GLState::GetLastFrameCounters();
+
+		check(counters.issued == 11 && counters.filtered == 395);
+		check(calls.size() == 11);
+	}
+}
+
+int main()
+{
+	InstallFakes();
+
+	TestBindingsAreFiltered();
+	TestTexturesAreFiltered();
+	TestFixedFunctionStateIsFiltered();
+	TestFrames();
+
+	return TestHelpers::Finish("GLStateTests");
+}
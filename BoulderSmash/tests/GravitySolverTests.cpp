@@ -0,0 +1,332 @@
+#include "TestHelpers.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include "physics/GravitySolver.hpp"
+#include "physics/RigidBodySolver.hpp"
+
+#define tickLength (1.0f / 60.0f)
+
+GameObject& AddBox(const glm::vec3& position, const glm::vec3& size, float mass)
+{
+	GameObject& gameObject = ECSManager::AddGameObject();
+
+	gameObject.Teleport(TRANSFORM_POSITION(position.x, position.y, position.z));
+	gameObject.AddComponent<BoxCollider>(BoxCollider::Register(TRANSFORM_DEFAULT, size, true));
+
+	if (mass > 0.0f)
+		gameObject.AddComponent<RigidBody>(RigidBody::Register(mass, glm::vec3{ 0.0f }, glm::vec3{ 0.0f }));
+
+	return gameObject;
+}
+
+// A fixed tick in the order BoulderSmash.cpp runs it.
+void Tick()
+{
+	for (GameObject* gameObject : ECSManager::GetGameObjects())
+		gameObject->previousTransform = gameObject->transform;
+
+	PhysicsWorld::Step(tickLength);
+	GravitySolver::Step();
+	RigidBodySolver::Step(tickLength);
+}
+
+RigidBody& AddBody(const glm::vec3& position, float mass)
+{
+	GameObject& gameObject = ECSManager::AddGameObject();
+
+	gameObject.Teleport(TRANSFORM_POSITION(position.x, position.y, position.z));
+
+	return gameObject.AddComponent<RigidBody>(RigidBody::Register(mass, glm::vec3{ 0.0f }, glm::vec3{ 0.0f }));
+}
+
+void Clear()
+{
+	std::vector<EntityID> ids;
+
+	for (GameObject* gameObject : ECSManager::GetGameObjects())
+		ids.push_back(gameObject->GetID());
+
+	for (EntityID id : ids)
+		ECSManager::DestroyGameObject(id);
+}
+
+// The O(n^2) sum Barnes-Hut approximates, with the same softening.
+glm::vec3 SumPairs(const std::vector<glm::vec3>& positions, const std::vector<float>& masses, std::size_t self)
+{
+	glm::vec3 acceleration{ 0.0f };
+	float softeningSquared = GravitySolver::softening * GravitySolver::softening;
+
+	for (std::size_t j = 0; j < positions.size(); ++j)
+	{
+		if (j == self)
+			continue;
+
+		glm::vec3 offset = positions[j] - positions[self];
+		float distanceSquared = glm::dot(offset, offset) + softeningSquared;
+
+		acceleration += offset * (masses[j] / (distanceSquared * std::sqrt(distanceSquared)));
+	}
+
+	return acceleration * GravitySolver::gravitationalConstant;
+}
+
+void Scatter(std::mt19937& random, int count, float spread)
+{
+	std::normal_distribution<float> position(0.0f, spread);
+	std::uniform_real_distribution<float> mass(0.5f, 2.0f);
+
+	for (int i = 0; i < count; ++i)
+		AddBody({ position(random), position(random), position(random) }, mass(random));
+}
+
+void Collect(std::vector<RigidBody*>& bodies, std::vector<glm::vec3>& positions, std::vector<float>& masses)
+{
+	bodies.clear();
+	positions.clear();
+	masses.clear();
+
+	ECSManager::ForEach<RigidBody>([&](RigidBody& body)
+	{
+		bodies.push_back(&body);
+		positions.push_back(body.gameObject->transform.position);
+		masses.push_back(body.mass);
+	});
+}
+
+// A body put to sleep next to a heavy attractor must start falling, and a faint pull must not wake it.
+void TestWakesSleepingBodies()
+{
+	RigidBody& near = AddBody({ 0.0f, 10.0f, 0.0f }, 1.0f);
+	RigidBody& far = AddBody({ 0.0f, 100000.0f, 0.0f }, 1.0f);
+	EntityID nearId = near.gameObject->GetID();
+
+	near.awake = false;
+	far.awake = false;
+
+	GravitySolver::attractors.push_back({ glm::vec3{ 0.0f }, 1000.0f });
+	GravitySolver::Step();
+
+	check(near.awake);
+	check(near.acceleration.y < -GravitySolver::wakeAcceleration);
+	check(!far.awake);
+
+	for (int i = 0; i < 30; ++i)
+	{
+		GravitySolver::Step();
+		RigidBodySolver::Step(tickLength);
+	}
+
+	RigidBody& fallen = ECSManager::GetGameObject(nearId)->GetComponent<RigidBody>();
+
+	check(fallen.awake);
+	check(fallen.linearVelocity.y < -1.0f);
+	check(fallen.gameObject->transform.position.y < 10.0f);
+
+	GravitySolver::attractors.clear();
+	Clear();
+}
+
+// Two boxes stacked on the ground under a steady pull must fall asleep and stay asleep, instead of waking every tick and settling again.
+void TestRestingBodiesStayAsleep()
+{
+	AddBox({ -10.0f, -1.0f, -10.0f }, { 20.0f, 1.0f, 20.0f }, 0.0f);
+
+	EntityID lower = AddBox({ 0.0f, -0.005f, 0.0f }, glm::vec3{ 1.0f }, 5.0f).GetID();
+	EntityID upper = AddBox({ 0.0f, 0.99f, 0.0f }, glm::vec3{ 1.0f }, 1.0f).GetID();
+
+	// About ten units a second squared straight down, on top of the pull between the two boxes.
+	GravitySolver::attractors.push_back({ glm::vec3{ 0.5f, -1000.0f, 0.5f }, 1e7f });
+
+	int wakeUps = 0;
+	int firstAsleep = -1;
+	bool wasAsleep = false;
+
+	for (int i = 0; i < 600; ++i)
+	{
+		Tick();
+
+		bool asleep = !ECSManager::GetGameObject(lower)->GetComponent<RigidBody>().awake && !ECSManager::GetGameObject(upper)->GetComponent<RigidBody>().awake;
+
+		if (asleep && firstAsleep < 0)
+			firstAsleep = i;
+
+		if (wasAsleep && !asleep)
+			wakeUps++;
+
+		wasAsleep = asleep;
+	}
+
+	GameObject& top = *ECSManager::GetGameObject(upper);
+
+	std::printf("Stack under a steady pull: asleep after %d ticks, woke %d times over the next %d\n", firstAsleep, wakeUps, 599 - firstAsleep);
+
+	check(firstAsleep >= 0 && firstAsleep < 120);
+	check(wakeUps == 0);
+	check(wasAsleep);
+	check(glm::length(top.GetComponent<RigidBody>().acceleration) > 5.0f);
+	check(std::abs(top.transform.position.y - 1.0f) < 0.05f);
+
+	// Turning the pull sideways changes it by far more than the threshold, so the stack wakes up and starts to slide.
+	GravitySolver::attractors[0].position = glm::vec3{ 1000.0f, 0.5f, 0.5f };
+	Tick();
+
+	check(top.GetComponent<RigidBody>().awake);
+	check(ECSManager::GetGameObject(lower)->GetComponent<RigidBody>().awake);
+
+	for (int i = 0; i < 30; ++i)
+		Tick();
+
+	check(top.transform.position.x > 0.1f);
+
+	GravitySolver::attractors.clear();
+	Clear();
+}
+
+// A body alone in one corner of a tight cluster's cube: at theta 0.8 the root passes the opening test from where the body sits,
+// and approximating it would pull the body towards a centre of mass that includes its own.
+void TestNoSelfPull()
+{
+	std::mt19937 random(3);
+	std::normal_distribution<float> spread(0.0f, 0.2f);
+	std::vector<RigidBody*> bodies;
+	std::vector<glm::vec3> positions;
+	std::vector<float> masses;
+
+	AddBody(glm::vec3{ 0.0f }, 4.0f);
+
+	for (int i = 0; i < 19; ++i)
+		AddBody({ 10.0f + spread(random), 10.0f + spread(random), 10.0f + spread(random) }, 1.0f);
+
+	Collect(bodies, positions, masses);
+
+	GravitySolver::theta = 0.8f;
+	GravitySolver::Step();
+
+	for (std::size_t i = 0; i < bodies.size(); ++i)
+	{
+		if (masses[i] != 4.0f)
+			continue;
+
+		glm::vec3 exact = SumPairs(positions, masses, i);
+		float error = glm::length(bodies[i]->acceleration - exact) / glm::length(exact);
+
+		std::printf("Lone body beside a cluster at theta 0.8: relative error %.5f\n", error);
+
+		check(error < 0.01f);
+	}
+
+	GravitySolver::theta = 0.5f;
+	Clear();
+}
+
+void TestAccuracy()
+{
+	std::mt19937 random(5);
+	std::vector<RigidBody*> bodies;
+	std::vector<glm::vec3> positions;
+	std::vector<float> masses;
+
+	Scatter(random, 400, 20.0f);
+	Collect(bodies, positions, masses);
+
+	std::printf("Barnes-Hut against the pair sum, 400 bodies in one cluster:\n");
+
+	for (float theta : { 0.0f, 0.3f, 0.5f, 0.8f })
+	{
+		GravitySolver::theta = theta;
+		GravitySolver::Step();
+
+		double meanError = 0.0;
+		double maxError = 0.0;
+
+		for (std::size_t i = 0; i < bodies.size(); ++i)
+		{
+			glm::vec3 exact = SumPairs(positions, masses, i);
+			double error = glm::length(bodies[i]->acceleration - exact) / glm::length(exact);
+
+			meanError += error;
+			maxError = std::max(maxError, error);
+		}
+
+		meanError /= bodies.size();
+
+		std::printf("  theta %.1f: mean relative error %.5f, worst %.5f\n", theta, meanError, maxError);
+
+		if (theta == 0.0f)
+			check(maxError < 1e-4);
+
+		if (theta == 0.5f)
+		{
+			check(meanError < 0.01);
+			check(maxError < 0.05);
+		}
+	}
+
+	GravitySolver::theta = 0.5f;
+	Clear();
+}
+
+// The pair sum over every body would take minutes at the top of the range, so it is timed on a fixed sample of bodies and scaled up;
+// the same sample gives the error of the tree against the exact sum.
+void MeasureScaling(int largest)
+{
+	constexpr std::size_t sampleSize = 1000;
+
+	std::mt19937 random(7);
+	std::vector<RigidBody*> bodies;
+	std::vector<glm::vec3> positions;
+	std::vector<float> masses;
+
+	std::printf("Gravity for every body (best of 3, ms): pair sum (from %zu sampled bodies) vs Barnes-Hut at theta 0.5\n", sampleSize);
+
+	for (int count : { 1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000 })
+	{
+		if (count > largest)
+			break;
+
+		Clear();
+		Scatter(random, count, 20.0f * std::cbrt(count / 400.0f));
+		Collect(bodies, positions, masses);
+
+		std::size_t stride = std::max<std::size_t>(1, positions.size() / sampleSize);
+		std::vector<std::size_t> sample;
+
+		for (std::size_t i = 0; i < positions.size() && sample.size() < sampleSize; i += stride)
+			sample.push_back(i);
+
+		std::vector<glm::vec3> exact(sample.size());
+
+		double sampled = TestHelpers::Measure([&]()
+		{
+			for (std::size_t s = 0; s < sample.size(); ++s)
+				exact[s] = SumPairs(positions, masses, sample[s]);
+		}, 3);
+
+		double pairs = sampled * positions.size() / sample.size();
+		double tree = TestHelpers::Measure([]() { GravitySolver::Step(); }, 3);
+		double meanError = 0.0;
+
+		for (std::size_t s = 0; s < sample.size(); ++s)
+			meanError += glm::length(bodies[sample[s]]->acceleration - exact[s]) / glm::length(exact[s]);
+
+		meanError /= sample.size();
+
+		std::printf("  %6d bodies: %10.2f vs %7.2f (%.0fx, %zu nodes, mean relative error %.5f)\n", count, pairs, tree, pairs / tree, GravitySolver::GetNodeCount(), meanError);
+
+		check(meanError < 0.01);
+	}
+
+	Clear();
+}
+
+int main(int argc, char** argv)
+{
+	TestWakesSleepingBodies();
+	TestRestingBodiesStayAsleep();
+	TestNoSelfPull();
+	TestAccuracy();
+	MeasureScaling(argc > 1 ? std::atoi(argv[1]) : 200000);
+
+	return TestHelpers::Finish("GravitySolverTests");
+}
@@ -0,0 +1,191 @@
+#include "TestHelpers.hpp"
+#include <climits>
+#include <vector>
+#include "core/Window.hpp"
+#include "audio/SoundManager.hpp"
+#include "rendering/Model.hpp"
+
+// Compile together with glad.c and Implementations.cpp from the repository root and link the libraries in Libraries/lib, as the
+// game project does. The asset is put in the cache by hand instead of imported, and the GL entry points it would reach are fakes,
+// so no model file, window or context is needed.
+#define assetPath "assets/characters/test/model/model.obj"
+
+int generatedObjects = 0;
+std::vector<unsigned int> deletedVertexArrays;
+std::vector<unsigned int> deletedBuffers;
+std::vector<unsigned int> deletedTextures;
+
+void APIENTRY FakeGenVertexArrays(GLsizei count, GLuint*) { generatedObjects += count; }
+void APIENTRY FakeGenBuffers(GLsizei count, GLuint*) { generatedObjects += count; }
+void APIENTRY FakeGenTextures(GLsizei count, GLuint*) { generatedObjects += count; }
+void APIENTRY FakeDeleteVertexArrays(GLsizei count, const GLuint* names) { deletedVertexArrays.insert(deletedVertexArrays.end(), names, names + count); }
+void APIENTRY FakeDeleteBuffers(GLsizei count, const GLuint* names) { deletedBuffers.insert(deletedBuffers.end(), names, names + count); }
+void APIENTRY FakeDeleteTextures(GLsizei count, const GLuint* names) { deletedTextures.insert(deletedTextures.end(), names, names + count); }
+
+void InstallFakes()
+{
+	glad_glGenVertexArrays = FakeGenVertexArrays;
+	glad_glGenBuffers = FakeGenBuffers;
+	glad_glGenTextures = FakeGenTextures;
+	glad_glDeleteVertexArrays = FakeDeleteVertexArrays;
+	glad_glDeleteBuffers = FakeDeleteBuffers;
+	glad_glDeleteTextures = FakeDeleteTextures;
+}
+
+// What Import leaves behind for a file with two meshes sharing one texture.
+void CacheAsset()
+{
+	ModelHandle asset = std::make_shared<ModelAsset>();
+	Texture texture;
+
+	texture.data.ID = 30;
+	texture.data.type = "texture_diffuse";
+
+	asset->path = assetPath;
+	asset->texturesLoaded.push_back(texture);
+
+	for (unsigned int m = 0; m < 2; ++m)
+	{
+		RenderableObject mesh;
+
+		mesh.VAO = 10 + m;
+		mesh.VBO = 20 + 2 * m;
+		mesh.EBO = 21 + 2 * m;
+		mesh.indexCount = 36;
+		mesh.RegisterTexture(texture);
+
+		asset->meshes.push_back(mesh);
+	}
+
+	ModelAssetManager::assets.emplace(assetPath, asset);
+}
+
+ShaderObject MakeShader()
+{
+	ShaderObject shader;
+
+	shader.name = "defaultShader";
+	shader.ID = 5;
+
+	return shader;
+}
+
+// Every Model of one path shares the asset's meshes: the renderer copies point at the same VAOs, nothing new is created on the
+// GPU, and the asset is freed by Collect only once the last Model and renderer copy are gone.
+void TestModelsShareOneAsset()
+{
+	CacheAsset();
+
+	ModelHandle asset = ModelAssetManager::Load(assetPath);
+
+	check(asset && asset->meshes.size() == 2);
+	check(ModelAssetManager::Load(assetPath) == asset);
+
+	asset.reset();
+
+	std::vector<EntityID> owners;
+
+	for (int i = 0; i < 50; ++i)
+	{
+		GameObject& gameObject = ECSManager::AddGameObject();
+
+		gameObject.AddComponent<Model>().GenerateModel(assetPath, "asteroid", glm::vec3{ static_cast<float>(i), 0.0f, 0.0f }, true, MakeShader());
+		owners.push_back(gameObject.GetID());
+	}
+
+	check(generatedObjects == 0);
+	check(Renderer::registeredObjects.size() == 100);
+	check(Renderer::registeredObjects[0].VAO == 10 && Renderer::registeredObjects[1].VAO == 11 && Renderer::registeredObjects[99].VAO == 11);
+	check(Renderer::registeredObjects[98].data.transform.position.x == 49.0f && Renderer::registeredObjects[98].owner == owners[49]);
+
+	// One reference per Model and one per renderer copy.
+	check(ModelAssetManager::GetReferenceCount(assetPath) == 150);
+
+	ModelAssetManager::Collect();
+
+	check(ModelAssetManager::assets.size() == 1 && deletedVertexArrays.empty());
+
+	// Destroying the owners drops the Models at once, and the renderer copies the next time orphans are removed.
+	for (int i = 0; i < 49; ++i)
+		ECSManager::DestroyGameObject(owners[i]);
+
+	check(ModelAssetManager::GetReferenceCount(assetPath) == 101);
+
+	Renderer::RemoveOrphanedObjects();
+
+	check(Renderer::registeredObjects.size() == 2 && ModelAssetManager::GetReferenceCount(assetPath) == 3);
+
+	ModelAssetManager::Collect();
+
+	check(ModelAssetManager::assets.size() == 1 && deletedVertexArrays.empty());
+
+	ECSManager::DestroyGameObject(owners[49]);
+	Renderer::RemoveOrphanedObjects();
+
+	check(ModelAssetManager::GetReferenceCount(assetPath) == 0);
+
+	ModelAssetManager::Collect();
+
+	check(ModelAssetManager::assets.empty() && ModelAssetManager::GetReferenceCount(assetPath) == 0);
+	check(deletedVertexArrays == std::vector<unsigned int>({ 10, 11 }));
+	check(deletedBuffers == std::vector<unsigned int>({ 20, 21, 22, 23 }));
+	check(deletedTextures == std::vector<unsigned int>({ 30 }));
+
+	deletedVertexArrays.clear();
+	deletedBuffers.clear();
+	deletedTextures.clear();
+}
+
+// A Model generated on a Prefab holds the asset without registering anything; each copy registers its meshes when it starts.
+void TestPrefabCopiesShareOneAsset()
+{
+	CacheAsset();
+
+	Prefab prefab;
+
+	prefab.AddComponent<Model>().GenerateModel(assetPath, "asteroid", glm::vec3{ 0.0f }, true, MakeShader());
+
+	check(Renderer::registeredObjects.empty());
+	check(ModelAssetManager::GetReferenceCount(assetPath) == 1);
+
+	std::vector<Transform> transforms(20, TRANSFORM_DEFAULT);
+	std::vector<EntityID> spawned;
+
+	ECSManager::Instantiate(prefab, transforms.size(), transforms, spawned);
+
+	check(spawned.size() == 20 && Renderer::registeredObjects.size() == 40);
+	check(ModelAssetManager::GetReferenceCount(assetPath) == 1 + 20 + 40);
+	check(generatedObjects == 0);
+
+	for (EntityID id : spawned)
+		ECSManager::DestroyGameObject(id);
+
+	Renderer::RemoveOrphanedObjects();
+	ModelAssetManager::Collect();
+
+	// The prefab still holds it.
+	check(ModelAssetManager::assets.size() == 1 && deletedVertexArrays.empty());
+
+	prefab = Prefab();
+	ModelAssetManager::Collect();
+
+	check(ModelAssetManager::assets.empty() && deletedVertexArrays.size() == 2);
+}
+
+// A file that cannot be imported is not cached, so a later Load tries again.
+void TestMissingFile()
+{
+	check(ModelAssetManager::Load("assets/missing.obj") == nullptr);
+	check(ModelAssetManager::assets.empty() && ModelAssetManager::GetReferenceCount("assets/missing.obj") == 0);
+}
+
+int main()
+{
+	InstallFakes();
+
+	TestModelsShareOneAsset();
+	TestPrefabCopiesShareOneAsset();
+	TestMissingFile();
+
+	return TestHelpers::Finish("ModelAssetTests");
+}
@@ -0,0 +1,208 @@
+#include "TestHelpers.hpp"
+#include <cmath>
+#include <random>
+#include "physics/Physics.hpp"
+
+#define tickLength (1.0f / 60.0f)
+
+EntityID AddBox(const glm::vec3& position, const glm::vec3& size, std::uint32_t layer = 1)
+{
+	GameObject& gameObject = ECSManager::AddGameObject();
+
+	gameObject.Teleport(TRANSFORM_POSITION(position.x, position.y, position.z));
+	gameObject.AddComponent<BoxCollider>(BoxCollider::Register(TRANSFORM_DEFAULT, size, true)).layer = layer;
+
+	return gameObject.GetID();
+}
+
+void Step()
+{
+	for (GameObject* gameObject : ECSManager::GetGameObjects())
+		gameObject->previousTransform = gameObject->transform;
+
+	PhysicsWorld::Step(tickLength);
+}
+
+void Clear()
+{
+	std::vector<EntityID> ids;
+
+	for (GameObject* gameObject : ECSManager::GetGameObjects())
+		ids.push_back(gameObject->GetID());
+
+	for (EntityID id : ids)
+		ECSManager::DestroyGameObject(id);
+
+	PhysicsWorld::Step(tickLength);
+}
+
+bool Near(const glm::vec3& a, const glm::vec3& b)
+{
+	return glm::length(a - b) < 1e-4f;
+}
+
+void TestRaycast()
+{
+	EntityID near = AddBox({ 5.0f, 0.0f, 0.0f }, glm::vec3{ 1.0f });
+	EntityID far = AddBox({ 10.0f, 0.0f, 0.0f }, glm::vec3{ 1.0f }, 2);
+
+	Step();
+
+	RaycastHit hit;
+
+	check(Physics::Raycast({ 0.0f, 0.5f, 0.5f }, { 1.0f, 0.0f, 0.0f }, 100.0f, hit));
+	check(hit.entity == near && hit.distance == 5.0f);
+	check(Near(hit.point, { 5.0f, 0.5f, 0.5f }) && hit.normal == glm::vec3{ -1.0f, 0.0f, 0.0f });
+
+	// The layer mask skips the nearer box.
+	check(Physics::Raycast({ 0.0f, 0.5f, 0.5f }, { 1.0f, 0.0f, 0.0f }, 100.0f, hit, 2) && hit.entity == far && hit.distance == 10.0f);
+
+	check(!Physics::Raycast({ 0.0f, 0.5f, 0.5f }, { 1.0f, 0.0f, 0.0f }, 4.0f, hit) && hit.entity == nullEntity);
+	check(!Physics::Raycast({ 0.0f, 0.5f, 0.5f }, { -1.0f, 0.0f, 0.0f }, 100.0f, hit));
+
+	// Down onto the top face.
+	check(Physics::Raycast({ 5.5f, 5.0f, 0.5f }, { 0.0f, -1.0f, 0.0f }, 100.0f, hit) && hit.entity == near && hit.distance == 4.0f && hit.normal == glm::vec3{ 0.0f, 1.0f, 0.0f });
+
+	// Starting inside hits at once, facing back along the ray.
+	check(Physics::Raycast({ 5.5f, 0.5f, 0.5f }, { 1.0f, 0.0f, 0.0f }, 100.0f, hit) && hit.entity == near && hit.distance == 0.0f && hit.normal == glm::vec3{ -1.0f, 0.0f, 0.0f });
+
+	// Axis-aligned rays starting exactly on the planes of a box's faces, where the slab test used to see 0 * inf.
+	check(Physics::Raycast({ 0.0f, 0.0f, 0.5f }, { 1.0f, 0.0f, 0.0f }, 100.0f, hit) && hit.entity == near && hit.distance == 5.0f);
+	check(Physics::Raycast({ 0.0f, 1.0f, 1.0f }, { 1.0f, 0.0f, 0.0f }, 100.0f, hit) && hit.entity == near && hit.distance == 5.0f);
+	check(Physics::Raycast({ 5.0f, 0.5f, -7.0f }, { 0.0f, 0.0f, 1.0f }, 100.0f, hit) && hit.entity == near && hit.distance == 7.0f);
+	check(!Physics::Raycast({ 0.0f, 1.001f, 0.5f }, { 1.0f, 0.0f, 0.0f }, 100.0f, hit));
+
+	std::vector<RaycastHit> hits;
+
+	Physics::RaycastAll({ 0.0f, 0.5f, 0.5f }, { 1.0f, 0.0f, 0.0f }, 100.0f, hits);
+
+	check(hits.size() == 2);
+	check(hits[0].entity == near && hits[0].distance == 5.0f);
+	check(hits[1].entity == far && hits[1].distance == 10.0f);
+
+	Physics::RaycastAll({ 0.0f, 0.5f, 0.5f }, { 1.0f, 0.0f, 0.0f }, 8.0f, hits);
+	check(hits.size() == 1 && hits[0].entity == near);
+
+	Physics::RaycastAll({ 0.0f, 0.5f, 0.5f }, { 1.0f, 0.0f, 0.0f }, 100.0f, hits, 2);
+	check(hits.size() == 1 && hits[0].entity == far);
+
+	Clear();
+}
+
+void TestShapeCasts()
+{
+	EntityID box = AddBox({ 5.0f, 0.0f, 0.0f }, glm::vec3{ 1.0f });
+
+	Step();
+
+	RaycastHit hit;
+
+	// A sphere stops its radius short of the face.
+	check(Physics::SphereCast({ 0.0f, 0.5f, 0.5f }, 0.5f, { 1.0f, 0.0f, 0.0f }, 100.0f, hit) && hit.entity == box && hit.distance == 4.5f && hit.normal == glm::vec3{ -1.0f, 0.0f, 0.0f });
+
+	// It catches a box its centre line passes beside, within its radius, and misses beyond it.
+	check(Physics::SphereCast({ 0.0f, 1.4f, 0.5f }, 0.5f, { 1.0f, 0.0f, 0.0f }, 100.0f, hit) && hit.distance == 4.5f);
+	check(!Physics::SphereCast({ 0.0f, 1.6f, 0.5f }, 0.5f, { 1.0f, 0.0f, 0.0f }, 100.0f, hit));
+
+	// Along an axis from exactly the grown box's face plane.
+	check(Physics::SphereCast({ 0.0f, 1.5f, 0.5f }, 0.5f, { 1.0f, 0.0f, 0.0f }, 100.0f, hit) && hit.distance == 4.5f);
+
+	// A box reaches as far as its own half size on each axis.
+	check(Physics::BoxCast({ 0.0f, 2.9f, 0.5f }, { 0.5f, 2.0f, 0.5f }, { 1.0f, 0.0f, 0.0f }, 100.0f, hit) && hit.entity == box && hit.distance == 4.5f);
+	check(!Physics::BoxCast({ 0.0f, 2.9f, 0.5f }, { 0.5f, 1.0f, 0.5f }, { 1.0f, 0.0f, 0.0f }, 100.0f, hit));
+	check(Physics::BoxCast({ 5.5f, 10.0f, 0.5f }, { 0.1f, 3.0f, 0.1f }, { 0.0f, -1.0f, 0.0f }, 100.0f, hit) && hit.distance == 6.0f && hit.normal == glm::vec3{ 0.0f, 1.0f, 0.0f });
+
+	check(!Physics::SphereCast({ 0.0f, 0.5f, 0.5f }, 0.5f, { 1.0f, 0.0f, 0.0f }, 4.0f, hit));
+
+	Clear();
+}
+
+// Random rays through a random scene, a third of them axis-aligned, against the nearest hit over every collider.
+void TestRaycastsMatchLoop()
+{
+	std::mt19937 random(17);
+	std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+	std::uniform_real_distribution<float> size(0.5f, 6.0f);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+	// Whole-number boxes and origins, so the axis-aligned rays often start on face planes.
+	for (int i = 0; i < 500; ++i)
+		AddBox({ std::floor(position(random)), std::floor(position(random)), std::floor(position(random)) }, glm::vec3{ std::floor(size(random)) }, 1 + i % 2);
+
+	Step();
+
+	std::vector<Ray> rays;
+
+	for (int r = 0; r < 600; ++r)
+	{
+		Ray ray;
+
+		ray.origin = { std::floor(position(random)), std::floor(position(random)), std::floor(position(random)) };
+		ray.maxDistance = 200.0f;
+		ray.layerMask = r % 5 == 0 ? 2u : allLayers;
+
+		if (r % 3 == 0)
+		{
+			ray.direction = glm::vec3{ 0.0f };
+			ray.direction[r % 9 / 3] = (r % 2 == 0) ? 1.0f : -1.0f;
+		}
+		else
+			ray.direction = glm::normalize(glm::vec3{ unit(random), unit(random), unit(random) });
+
+		rays.push_back(ray);
+	}
+
+	std::vector<RaycastHit> batched;
+
+	Physics::RaycastBatch(rays, batched);
+
+	check(batched.size() == rays.size());
+
+	int hits = 0;
+
+	for (std::size_t r = 0; r < rays.size(); ++r)
+	{
+		const Ray& ray = rays[r];
+		glm::vec3 inverseDirection = 1.0f / ray.direction;
+		float nearest = ray.maxDistance;
+		bool found = false;
+
+		for (std::uint32_t c = 0; c < 500; ++c)
+		{
+			float distance;
+
+			if ((PhysicsWorld::GetLayer(c) & ray.layerMask) && PhysicsWorld::GetBounds(c).IntersectsRay(ray.origin, inverseDirection, nearest, distance))
+			{
+				nearest = distance;
+				found = true;
+			}
+		}
+
+		RaycastHit hit;
+
+		check(Physics::Raycast(ray.origin, ray.direction, ray.maxDistance, hit, ray.layerMask) == found);
+		check(batched[r].entity == hit.entity);
+
+		if (found)
+		{
+			check(!std::isnan(hit.distance) && hit.distance == nearest);
+			check(batched[r].distance == hit.distance);
+			hits++;
+		}
+	}
+
+	std::printf("%d of %zu random rays hit\n", hits, rays.size());
+
+	check(hits > 100);
+
+	Clear();
+}
+
+int main()
+{
+	TestRaycast();
+	TestShapeCasts();
+	TestRaycastsMatchLoop();
+
+	return TestHelpers::Finish("PhysicsTests");
+}
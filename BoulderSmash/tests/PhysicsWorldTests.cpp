@@ -0,0 +1,108 @@
+#include "TestHelpers.hpp"
+#include <cmath>
+#include "physics/PhysicsWorld.hpp"
+
+#define tickLength (1.0f / 60.0f)
+
+GameObject& AddBox(const glm::vec3& position, const glm::vec3& size, const glm::vec3& velocity, bool continuous)
+{
+	GameObject& gameObject = ECSManager::AddGameObject();
+
+	gameObject.Teleport(TRANSFORM_POSITION(position.x, position.y, position.z));
+	gameObject.AddComponent<BoxCollider>(BoxCollider::Register(TRANSFORM_DEFAULT, size, true, continuous));
+
+	if (velocity != glm::vec3{ 0.0f })
+		gameObject.AddComponent<RigidBody>(RigidBody::Register(1.0f, velocity, glm::vec3{ 0.0f }));
+
+	return gameObject;
+}
+
+// Steps the world alone, without the solver, so the pairs describe where the colliders start the tick.
+void Step()
+{
+	for (GameObject* gameObject : ECSManager::GetGameObjects())
+		gameObject->previousTransform = gameObject->transform;
+
+	PhysicsWorld::Step(tickLength);
+}
+
+// Returns the time of impact PhysicsWorld found for the pair, or -1 when it kept no such pair.
+float FindTimeOfImpact(EntityID a, EntityID b)
+{
+	const std::vector<ColliderPair>& pairs = PhysicsWorld::GetPairs();
+
+	for (std::size_t p = 0; p < pairs.size(); ++p)
+	{
+		EntityID first = PhysicsWorld::GetEntity(pairs[p].a);
+		EntityID second = PhysicsWorld::GetEntity(pairs[p].b);
+
+		if ((first == a && second == b) || (first == b && second == a))
+			return PhysicsWorld::GetTimeOfImpact(p);
+	}
+
+	return -1.0f;
+}
+
+void Clear()
+{
+	std::vector<EntityID> ids;
+
+	for (GameObject* gameObject : ECSManager::GetGameObjects())
+		ids.push_back(gameObject->GetID());
+
+	for (EntityID id : ids)
+		ECSManager::DestroyGameObject(id);
+
+	PhysicsWorld::Step(tickLength);
+}
+
+// At 600 units a second a unit box moves ten units a tick; the first hits the wall two units ahead a fifth of the way through the tick, although it starts and ends the tick clear of it.
+void TestContinuousPairs()
+{
+	EntityID wall = AddBox({ 3.0f, -5.0f, -5.0f }, { 0.2f, 10.0f, 10.0f }, glm::vec3{ 0.0f }, false).GetID();
+	EntityID fast = AddBox({ 0.0f, 0.0f, 0.0f }, glm::vec3{ 1.0f }, { 600.0f, 0.0f, 0.0f }, true).GetID();
+
+	// Both moving, closing on each other at 240 units a second each, eight units a tick together, over a three-unit gap.
+	EntityID left = AddBox({ -3.0f, 20.0f, 0.0f }, glm::vec3{ 1.0f }, { 240.0f, 0.0f, 0.0f }, true).GetID();
+	EntityID right = AddBox({ 1.0f, 20.0f, 0.0f }, glm::vec3{ 1.0f }, { -240.0f, 0.0f, 0.0f }, true).GetID();
+
+	// Already overlapping while flying apart.
+	EntityID inside = AddBox({ 0.0f, 40.0f, 0.0f }, glm::vec3{ 1.0f }, { -600.0f, 0.0f, 0.0f }, true).GetID();
+	EntityID overlapped = AddBox({ 0.5f, 40.0f, 0.0f }, glm::vec3{ 1.0f }, { 600.0f, 0.0f, 0.0f }, false).GetID();
+
+	// Near misses whose swept volumes overlap: a hundredth of a unit beside a thin post, and cutting past a box's corner.
+	EntityID post = AddBox({ 3.0f, 61.01f, 0.0f }, { 0.2f, 5.0f, 1.0f }, glm::vec3{ 0.0f }, false).GetID();
+	EntityID passing = AddBox({ 1.0f, 60.0f, 0.0f }, glm::vec3{ 1.0f }, { 600.0f, 0.0f, 0.0f }, true).GetID();
+	EntityID corner = AddBox({ 3.0f, 80.0f, 0.0f }, glm::vec3{ 1.0f }, glm::vec3{ 0.0f }, false).GetID();
+	EntityID cutting = AddBox({ 0.0f, 80.0f, 0.0f }, glm::vec3{ 1.0f }, { 240.0f, 240.0f, 0.0f }, true).GetID();
+
+	// Discrete colliders overlapping where they are now, whose time of impact is always the end of the tick.
+	EntityID resting = AddBox({ 0.0f, 100.0f, 0.0f }, glm::vec3{ 1.0f }, glm::vec3{ 0.0f }, false).GetID();
+	EntityID touching = AddBox({ 0.5f, 100.0f, 0.0f }, glm::vec3{ 1.0f }, glm::vec3{ 0.0f }, false).GetID();
+
+	for (BroadphaseType type : { BroadphaseType::SPATIAL_HASH, BroadphaseType::AABB_TREE })
+	{
+		PhysicsWorld::broadphaseType = type;
+		Step();
+
+		check(std::abs(FindTimeOfImpact(fast, wall) - 0.2f) < 1e-4f);
+		check(std::abs(FindTimeOfImpact(left, right) - 0.375f) < 1e-4f);
+		check(FindTimeOfImpact(inside, overlapped) == 0.0f);
+		check(FindTimeOfImpact(passing, post) == -1.0f);
+		check(FindTimeOfImpact(cutting, corner) == -1.0f);
+		check(FindTimeOfImpact(resting, touching) == 1.0f);
+
+		// Nothing else meets: the scenarios are far enough apart that only the pairs above can be found.
+		check(PhysicsWorld::GetPairs().size() == 4);
+	}
+
+	PhysicsWorld::broadphaseType = BroadphaseType::SPATIAL_HASH;
+	Clear();
+}
+
+int main()
+{
+	TestContinuousPairs();
+
+	return TestHelpers::Finish("PhysicsWorldTests");
+}
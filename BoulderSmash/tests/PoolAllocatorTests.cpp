@@ -0,0 +1,135 @@
+#include "TestHelpers.hpp"
+#include <cstdint>
+#include <random>
+#include <set>
+#include "core/ECS.hpp"
+
+struct alignas(32) Particle
+{
+	Particle(int value = 0) : value(value) { }
+
+	int value;
+};
+
+struct Health : Component
+{
+	Health(int value = 0) : value(value) { }
+
+	int value;
+};
+
+struct Speed : Component
+{
+	Speed(float value = 0.0f) : value(value) { }
+
+	float value;
+};
+
+// Slabs are the only thing the pool allocates, so every cycle after the first must be served from the free list.
+void TestPoolReusesBlocks()
+{
+	std::mt19937 random(9);
+	ObjectPool<Particle> pool(64);
+	std::vector<Particle*> live;
+
+	for (int i = 0; i < 200; ++i)
+		live.push_back(pool.Create(i));
+
+	std::set<Particle*> unique(live.begin(), live.end());
+
+	check(unique.size() == live.size());
+
+	for (int i = 0; i < 200; ++i)
+	{
+		check(reinterpret_cast<std::uintptr_t>(live[i]) % alignof(Particle) == 0);
+		check(live[i]->value == i);
+	}
+
+	for (Particle* particle : live)
+		pool.Destroy(particle);
+
+	live.clear();
+
+	std::size_t capacity = pool.allocator.GetCapacity();
+	std::size_t allocations = AllocationCounter::allocations;
+
+	for (int cycle = 0; cycle < 1000; ++cycle)
+	{
+		for (int i = 0; i < 200; ++i)
+			live.push_back(pool.Create(i));
+
+		// Free in a shuffled order, so the free list comes back scrambled for the next cycle.
+		std::shuffle(live.begin(), live.end(), random);
+
+		for (Particle* particle : live)
+			pool.Destroy(particle);
+
+		live.clear();
+	}
+
+	check(AllocationCounter::allocations == allocations);
+	check(pool.allocator.GetCapacity() == capacity);
+	check(pool.allocator.GetActiveCount() == 0);
+}
+
+// Entities spawned and destroyed every tick, directly and through a command buffer, stop allocating once the pools and columns have grown to fit.
+void TestEntityChurnStopsAllocating()
+{
+	auto cycle = []()
+	{
+		std::vector<EntityID> ids;
+
+		for (int i = 0; i < 500; ++i)
+		{
+			GameObject& gameObject = ECSManager::AddGameObject();
+
+			gameObject.AddComponent<Health>(i);
+
+			if (i % 2 == 0)
+				gameObject.AddComponent<Speed>(static_cast<float>(i));
+
+			ids.push_back(gameObject.GetID());
+		}
+
+		EntityCommandBuffer& buffer = ECSManager::GetCommandBuffer();
+
+		for (int i = 0; i < 100; ++i)
+			buffer.AddComponent<Health>(buffer.Spawn(), i);
+
+		for (EntityID id : ids)
+			buffer.Destroy(id);
+
+		ECSManager::PlaybackCommandBuffers();
+
+		ids.clear();
+
+		for (GameObject* gameObject : ECSManager::GetGameObjects())
+			ids.push_back(gameObject->GetID());
+
+		for (EntityID id : ids)
+			ECSManager::DestroyGameObject(id);
+	};
+
+	std::size_t coldAllocations = AllocationCounter::allocations;
+
+	cycle();
+
+	std::size_t allocations = AllocationCounter::allocations;
+
+	// The first cycle grows the pools, the columns and the payload blocks, all through the counter.
+	check(allocations > coldAllocations);
+
+	for (int i = 0; i < 100; ++i)
+		cycle();
+
+	check(AllocationCounter::allocations == allocations);
+	check(ECSManager::GetGameObjects().empty());
+}
+
+int main()
+{
+	TestPoolReusesBlocks();
+	TestEntityChurnStopsAllocating();
+
+	return TestHelpers::Finish("PoolAllocatorTests");
+}
@@ -0,0 +1,204 @@
+#include "TestHelpers.hpp"
+#include <random>
+#include <vector>
+#include "rendering/RenderQueue.hpp"
+
+// Where each field of an opaque key sits, from the bottom bit up: depth(18), VAO(16), material(16), program(12), pass(2).
+void TestOpaqueKeyLayout()
+{
+	float step = RenderQueue::depthRange / 0x3FFFF;
+
+	check(RenderQueue::MakeKey(opaquePass, 0, 0, 0, 0.0f) == 0);
+	check(RenderQueue::MakeKey(opaquePass, 0, 0, 1, 0.0f) == 1ull << 18);
+	check(RenderQueue::MakeKey(opaquePass, 0, 1, 0, 0.0f) == 1ull << 34);
+	check(RenderQueue::MakeKey(opaquePass, 1, 0, 0, 0.0f) == 1ull << 50);
+	check(RenderQueue::MakeKey(opaquePass, 0, 0, 0, RenderQueue::depthRange) == 0x3FFFF);
+	check(RenderQueue::MakeKey(opaquePass, 0, 0, 0, step * 100.5f) == 100);
+	check(RenderQueue::GetPass(RenderQueue::MakeKey(opaquePass, 0xFFF, 0xFFFF, 0xFFFF, RenderQueue::depthRange)) == opaquePass);
+
+	// Fields are cut to their width rather than spilling into the next one.
+	check(RenderQueue::MakeKey(opaquePass, 0x1001, 0x10002, 0x10003, 0.0f) == RenderQueue::MakeKey(opaquePass, 1, 2, 3, 0.0f));
+
+	// Depth outside the range clamps to its ends.
+	check(RenderQueue::MakeKey(opaquePass, 1, 2, 3, -5.0f) == RenderQueue::MakeKey(opaquePass, 1, 2, 3, 0.0f));
+	check(RenderQueue::MakeKey(opaquePass, 1, 2, 3, RenderQueue::depthRange * 4.0f) == RenderQueue::MakeKey(opaquePass, 1, 2, 3, RenderQueue::depthRange));
+
+	// State outranks depth, and program outranks material outranks VAO.
+	check(RenderQueue::MakeKey(opaquePass, 1, 1, 1, 5.0f) < RenderQueue::MakeKey(opaquePass, 1, 1, 1, 50.0f));
+	check(RenderQueue::MakeKey(opaquePass, 1, 1, 1, 1000.0f) < RenderQueue::MakeKey(opaquePass, 1, 1, 2, 0.0f));
+	check(RenderQueue::MakeKey(opaquePass, 1, 1, 0xFFFF, 1000.0f) < RenderQueue::MakeKey(opaquePass, 1, 2, 0, 0.0f));
+	check(RenderQueue::MakeKey(opaquePass, 1, 0xFFFF, 0xFFFF, 1000.0f) < RenderQueue::MakeKey(opaquePass, 2, 0, 0, 0.0f));
+}
+
+// Transparent keys: pass(2) at the top, then inverted depth(18), then program, material and VAO as in an opaque key.
+void TestTransparentKeyLayout()
+{
+	std::uint64_t nearest = RenderQueue::MakeKey(transparentPass, 0, 0, 0, 0.0f);
+	std::uint64_t farthest = RenderQueue::MakeKey(transparentPass, 0, 0, 0, RenderQueue::depthRange);
+
+	check(RenderQueue::GetPass(nearest) == transparentPass && RenderQueue::GetPass(farthest) == transparentPass);
+	check(nearest == ((1ull << 62) | (0x3FFFFull << 44)));
+	check(farthest == 1ull << 62);
+	check(RenderQueue::MakeKey(transparentPass, 1, 2, 3, RenderQueue::depthRange) == ((1ull << 62) | (1ull << 32) | (2ull << 16) | 3));
+
+	// Every opaque key sorts before every transparent one.
+	check(RenderQueue::MakeKey(opaquePass, 0xFFF, 0xFFFF, 0xFFFF, RenderQueue::depthRange) < farthest);
+
+	// Farther first, whatever the state.
+	check(RenderQueue::MakeKey(transparentPass, 9, 9, 9, 50.0f) < RenderQueue::MakeKey(transparentPass, 0, 0, 0, 5.0f));
+	check(RenderQueue::MakeKey(transparentPass, 1, 1, 1, 50.0f) < RenderQueue::MakeKey(transparentPass, 1, 1, 2, 50.0f));
+}
+
+bool MatchesStableSort(RenderQueue& queue, std::vector<DrawItem> expected)
+{
+	queue.Sort();
+	std::stable_sort(expected.begin(), expected.end(), [](const DrawItem& a, const DrawItem& b) { return a.key < b.key; });
+
+	const std::vector<DrawItem>& items = queue.GetItems();
+
+	if (items.size() != expected.size())
+		return false;
+
+	for (std::size_t i = 0; i < items.size(); ++i)
+	{
+		if (items[i].key != expected[i].key || items[i].index != expected[i].index || items[i].instanced != expected[i].instanced)
+			return false;
+	}
+
+	return true;
+}
+
+// The radix sort must give exactly what a stable comparison sort gives, so equal keys keep their submission order.
+void TestSortIsStable()
+{
+	std::mt19937_64 random(3);
+	RenderQueue queue;
+	std::vector<DrawItem> expected;
+
+	check(MatchesStableSort(queue, expected));
+
+	queue.Push(42, 0, true);
+	expected.push_back({ 42, 0, true });
+	check(MatchesStableSort(queue, expected));
+
+	// Random keys over every byte.
+	queue.Clear();
+	expected.clear();
+
+	for (std::uint32_t i = 0; i < 5000; ++i)
+	{
+		std::uint64_t key = random();
+
+		queue.Push(key, i, i % 3 == 0);
+		expected.push_back({ key, i, i % 3 == 0 });
+	}
+
+	check(MatchesStableSort(queue, expected));
+
+	// Few distinct keys, with whole bytes every key shares, which the sort skips; most items tie with many others.
+	queue.Clear();
+	expected.clear();
+
+	for (std::uint32_t i = 0; i < 5000; ++i)
+	{
+		std::uint64_t key = random() & 0xC000030000000F03ull;
+
+		queue.Push(key, i, false);
+		expected.push_back({ key, i, false });
+	}
+
+	check(MatchesStableSort(queue, expected));
+
+	// Every key equal.
+	queue.Clear();
+	expected.clear();
+
+	for (std::uint32_t i = 0; i < 1000; ++i)
+	{
+		queue.Push(7, i, false);
+		expected.push_back({ 7, i, false });
+	}
+
+	check(MatchesStableSort(queue, expected));
+
+	// Sorting again after a Clear starts from nothing.
+	queue.Clear();
+	queue.Sort();
+	check(queue.GetItems().empty());
+}
+
+// Draws built as Renderer builds them come out grouped by program, then material, then VAO, and nearest first within a group.
+void TestFrameOrder()
+{
+	std::mt19937 random(11);
+	std::uniform_real_distribution<float> depth(0.0f, RenderQueue::depthRange);
+	RenderQueue queue;
+
+	for (std::uint32_t i = 0; i < 2000; ++i)
+		queue.Push(RenderQueue::MakeKey(i % 9 == 0 ? transparentPass : opaquePass, 1 + i % 3, 100 + i % 4, 10 + i % 2, depth(random)), i, false);
+
+	queue.Sort();
+
+	const std::vector<DrawItem>& items = queue.GetItems();
+	int programChanges = 0;
+
+	for (std::size_t i = 1; i < items.size(); ++i)
+	{
+		std::uint64_t previous = items[i - 1].key;
+		std::uint64_t current = items[i].key;
+
+		check(previous <= current);
+		check(RenderQueue::GetPass(previous) <= RenderQueue::GetPass(current));
+
+		if (RenderQueue::GetPass(current) == opaquePass && (previous >> 50) != (current >> 50))
+			programChanges++;
+	}
+
+	check(programChanges == 2);
+}
+
+void MeasureSort()
+{
+	std::mt19937 random(13);
+	std::uniform_real_distribution<float> depth(0.0f, RenderQueue::depthRange);
+	std::vector<std::uint64_t> keys;
+
+	for (std::uint32_t i = 0; i < 100000; ++i)
+		keys.push_back(RenderQueue::MakeKey(i % 7 == 0 ? transparentPass : opaquePass, i % 5, i % 11, i % 13, depth(random)));
+
+	RenderQueue queue;
+	std::vector<DrawItem> reference;
+
+	double radix = TestHelpers::Measure([&]()
+	{
+		queue.Clear();
+
+		for (std::uint32_t i = 0; i < keys.size(); ++i)
+			queue.Push(keys[i], i, false);
+
+		queue.Sort();
+	});
+
+	double comparison = TestHelpers::Measure([&]()
+	{
+		reference.clear();
+
+		for (std::uint32_t i = 0; i < keys.size(); ++i)
+			reference.push_back({ keys[i], i, false });
+
+		std::stable_sort(reference.begin(), reference.end(), [](const DrawItem& a, const DrawItem& b) { return a.key < b.key; });
+	});
+
+	std::printf("Filling and sorting 100000 draws (best of 5, ms): radix %.2f vs std::stable_sort %.2f\n", radix, comparison);
+}
+
+int main()
+{
+	TestOpaqueKeyLayout();
+	TestTransparentKeyLayout();
+	TestSortIsStable();
+	TestFrameOrder();
+	MeasureSort();
+
+	return TestHelpers::Finish("RenderQueueTests");
+}
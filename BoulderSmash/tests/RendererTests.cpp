@@ -0,0 +1,263 @@
+#include "TestHelpers.hpp"
+#include <climits>
+#include <vector>
+#include "core/Window.hpp"
+#include "audio/SoundManager.hpp"
+#include "rendering/Renderer.hpp"
+
+// Compile together with glad.c from the repository root and link the libraries in Libraries/lib, as the game project does.
+// The GL entry points the renderer reaches are pointed at the fakes below, so no window or context is needed.
+struct InstancedDraw
+{
+	unsigned int vertexArray;
+	int count;
+	std::vector<InstanceData> instances;
+};
+
+std::vector<InstancedDraw> instancedDraws;
+std::vector<unsigned int> draws;
+std::vector<unsigned int> deletedBuffers;
+std::vector<InstanceData> lastUpload;
+int programBinds = 0;
+int divisorCalls = 0;
+unsigned int boundVertexArray = 0;
+unsigned int nextBuffer = 100;
+
+void APIENTRY FakeUseProgram(GLuint) { programBinds++; }
+void APIENTRY FakeBindVertexArray(GLuint vertexArray) { boundVertexArray = vertexArray; }
+void APIENTRY FakeBindBuffer(GLenum, GLuint) { }
+void APIENTRY FakeBindBufferBase(GLenum, GLuint, GLuint) { }
+void APIENTRY FakeBufferData(GLenum, GLsizeiptr, const void*, GLenum) { }
+void APIENTRY FakeActiveTexture(GLenum) { }
+void APIENTRY FakeBindTexture(GLenum, GLuint) { }
+void APIENTRY FakeVertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*) { }
+void APIENTRY FakeEnableVertexAttribArray(GLuint) { }
+void APIENTRY FakeVertexAttribDivisor(GLuint, GLuint) { divisorCalls++; }
+void APIENTRY FakeUniform1i(GLint, GLint) { }
+void APIENTRY FakeUniform1f(GLint, GLfloat) { }
+void APIENTRY FakeUniformMatrix4fv(GLint, GLsizei, GLboolean, const GLfloat*) { }
+void APIENTRY FakeDepthMask(GLboolean) { }
+
+void APIENTRY FakeGenBuffers(GLsizei count, GLuint* buffers)
+{
+	for (GLsizei b = 0; b < count; ++b)
+		buffers[b] = nextBuffer++;
+}
+
+void APIENTRY FakeDeleteBuffers(GLsizei count, const GLuint* buffers)
+{
+	deletedBuffers.insert(deletedBuffers.end(), buffers, buffers + count);
+}
+
+void APIENTRY FakeBufferSubData(GLenum, GLintptr, GLsizeiptr size, const void* data)
+{
+	const InstanceData* instances = static_cast<const InstanceData*>(data);
+
+	lastUpload.assign(instances, instances + size / sizeof(InstanceData));
+}
+
+void APIENTRY FakeDrawElements(GLenum, GLsizei, GLenum, const void*)
+{
+	draws.push_back(boundVertexArray);
+}
+
+void APIENTRY FakeDrawElementsInstanced(GLenum, GLsizei, GLenum, const void*, GLsizei count)
+{
+	instancedDraws.push_back({ boundVertexArray, count, lastUpload });
+}
+
+void InstallFakes()
+{
+	glad_glUseProgram = FakeUseProgram;
+	glad_glBindVertexArray = FakeBindVertexArray;
+	glad_glBindBuffer = FakeBindBuffer;
+	glad_glBindBufferBase = FakeBindBufferBase;
+	glad_glBufferData = FakeBufferData;
+	glad_glBufferSubData = FakeBufferSubData;
+	glad_glGenBuffers = FakeGenBuffers;
+	glad_glDeleteBuffers = FakeDeleteBuffers;
+	glad_glActiveTexture = FakeActiveTexture;
+	glad_glBindTexture = FakeBindTexture;
+	glad_glVertexAttribPointer = FakeVertexAttribPointer;
+	glad_glEnableVertexAttribArray = FakeEnableVertexAttribArray;
+	glad_glVertexAttribDivisor = FakeVertexAttribDivisor;
+	glad_glUniform1i = FakeUniform1i;
+	glad_glUniform1f = FakeUniform1f;
+	glad_glUniformMatrix4fv = FakeUniformMatrix4fv;
+	glad_glDepthMask = FakeDepthMask;
+	glad_glDrawElements = FakeDrawElements;
+	glad_glDrawElementsInstanced = FakeDrawElementsInstanced;
+}
+
+RenderableObject MakeObject(unsigned int vertexArray, unsigned int program, bool instanced, EntityID owner)
+{
+	RenderableObject object;
+
+	object.VAO = vertexArray;
+	object.indexCount = 36;
+	object.owner = owner;
+	object.data.shader.ID = program;
+	object.data.shader.instanced = instanced;
+	object.data.doDefaultLighting = true;
+
+	return object;
+}
+
+void RenderFrame(std::shared_ptr<Camera>& camera)
+{
+	instancedDraws.clear();
+	draws.clear();
+	programBinds = 0;
+	divisorCalls = 0;
+
+	GLState::BeginFrame();
+	TransformHierarchy::Update(1.0f);
+	Renderer::RenderObjects(camera);
+	Renderer::RenderTransparentObjects();
+}
+
+// Every copy of a mesh drawn by an instanced program goes out in one call per mesh, carrying each owner's world matrix;
+// objects drawn by other programs still get a draw each.
+void TestInstancedBatches()
+{
+	std::shared_ptr<Camera> camera = std::make_shared<Camera>();
+	std::vector<EntityID> owners;
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		GameObject& gameObject = ECSManager::AddGameObject();
+
+		gameObject.Teleport(TRANSFORM_POSITION(static_cast<float>(i), 0.0f, 0.0f));
+		owners.push_back(gameObject.GetID());
+
+		Renderer::RegisterRenderableObject(MakeObject(1, 5, true, gameObject.GetID()));
+		Renderer::RegisterRenderableObject(MakeObject(2, 5, true, gameObject.GetID()));
+	}
+
+	Renderer::RegisterRenderableObject(MakeObject(9, 6, false, nullEntity));
+	Renderer::RegisterRenderableObject(MakeObject(9, 6, false, nullEntity));
+
+	RenderFrame(camera);
+
+	check(instancedDraws.size() == 2 && draws.size() == 2);
+	check(programBinds == 2);
+	check(Renderer::instanceBatches.size() == 2);
+
+	// Each VAO has its instance attributes pointed once: four model columns, three normal columns and the tint.
+	check(divisorCalls == 2 * 8);
+
+	for (const InstancedDraw& draw : instancedDraws)
+	{
+		check(draw.vertexArray == 1 || draw.vertexArray == 2);
+		check(draw.count == 1000 && draw.instances.size() == 1000);
+
+		bool placed = true;
+
+		for (int i = 0; i < 1000; ++i)
+			placed &= draw.instances[i].model[3] == glm::vec4(static_cast<float>(i), 0.0f, 0.0f, 1.0f) && draw.instances[i].tint == glm::vec4{ 1.0f };
+
+		check(placed);
+	}
+
+	check(instancedDraws[0].vertexArray != instancedDraws[1].vertexArray);
+	check(draws[0] == 9 && draws[1] == 9);
+
+	// The next frame reuses the batches and leaves the attributes alone.
+	RenderFrame(camera);
+
+	check(instancedDraws.size() == 2 && instancedDraws[0].count == 1000 && divisorCalls == 0);
+
+	// Destroyed owners drop out of the batches.
+	for (int i = 0; i < 1000; i += 2)
+		ECSManager::DestroyGameObject(owners[i]);
+
+	RenderFrame(camera);
+
+	check(instancedDraws.size() == 2 && instancedDraws[0].count == 500 && instancedDraws[1].count == 500);
+	check(instancedDraws[0].instances[0].model[3].x == 1.0f && instancedDraws[0].instances[499].model[3].x == 999.0f);
+	check(Renderer::registeredObjects.size() == 1002);
+
+	// A batch left with nothing to draw gives its buffer back.
+	deletedBuffers.clear();
+
+	for (int i = 1; i < 1000; i += 2)
+		ECSManager::DestroyGameObject(owners[i]);
+
+	RenderFrame(camera);
+
+	check(instancedDraws.empty() && draws.size() == 2);
+	check(deletedBuffers.size() == 2 && Renderer::instanceBatches.empty() && Renderer::instanceAttributeBuffers.empty());
+
+	Renderer::registeredObjects.clear();
+	RenderFrame(camera);
+}
+
+// Instanced programs sharing one mesh get a batch each, with the VAO's attributes pointed at whichever batch is being drawn.
+void TestProgramsSharingAMesh()
+{
+	std::shared_ptr<Camera> camera = std::make_shared<Camera>();
+	std::vector<EntityID> owners;
+
+	for (int i = 0; i < 10; ++i)
+	{
+		GameObject& gameObject = ECSManager::AddGameObject();
+
+		owners.push_back(gameObject.GetID());
+
+		Renderer::RegisterRenderableObject(MakeObject(3, i < 4 ? 7 : 8, true, gameObject.GetID()));
+	}
+
+	RenderFrame(camera);
+
+	check(instancedDraws.size() == 2 && programBinds == 2);
+	check(instancedDraws[0].count + instancedDraws[1].count == 10);
+	check(instancedDraws[0].count == 4 || instancedDraws[0].count == 6);
+
+	// Both batches draw from VAO 3, so its attributes are re-pointed every time the batch changes.
+	check(divisorCalls == 2 * 8);
+
+	for (EntityID owner : owners)
+		ECSManager::DestroyGameObject(owner);
+
+	Renderer::registeredObjects.clear();
+	RenderFrame(camera);
+}
+
+void MeasureInstancing()
+{
+	std::shared_ptr<Camera> camera = std::make_shared<Camera>();
+	std::vector<EntityID> owners;
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		GameObject& gameObject = ECSManager::AddGameObject();
+
+		gameObject.Teleport(TRANSFORM_POSITION(static_cast<float>(i % 100), 0.0f, static_cast<float>(i / 100)));
+		owners.push_back(gameObject.GetID());
+
+		Renderer::RegisterRenderableObject(MakeObject(1, 5, true, gameObject.GetID()));
+	}
+
+	double frame = TestHelpers::Measure([&]() { RenderFrame(camera); });
+
+	std::printf("10000 instanced objects: %zu draw call(s), %.2f ms to gather and submit a frame\n", instancedDraws.size(), frame);
+
+	check(instancedDraws.size() == 1 && instancedDraws[0].count == 10000);
+
+	for (EntityID owner : owners)
+		ECSManager::DestroyGameObject(owner);
+
+	Renderer::registeredObjects.clear();
+	RenderFrame(camera);
+}
+
+int main()
+{
+	InstallFakes();
+
+	TestInstancedBatches();
+	TestProgramsSharingAMesh();
+	MeasureInstancing();
+
+	return TestHelpers::Finish("RendererTests");
+}
@@ -0,0 +1,120 @@
+#include "TestHelpers.hpp"
+#include <cmath>
+#include "physics/RigidBodySolver.hpp"
+
+#define tickLength (1.0f / 60.0f)
+
+GameObject& AddBox(const glm::vec3& position, const glm::vec3& size, bool continuous)
+{
+	GameObject& gameObject = ECSManager::AddGameObject();
+
+	gameObject.Teleport(TRANSFORM_POSITION(position.x, position.y, position.z));
+	gameObject.AddComponent<BoxCollider>(BoxCollider::Register(TRANSFORM_DEFAULT, size, true, continuous));
+
+	return gameObject;
+}
+
+GameObject& AddBody(const glm::vec3& position, const glm::vec3& velocity, bool continuous)
+{
+	GameObject& gameObject = AddBox(position, glm::vec3{ 1.0f }, continuous);
+
+	gameObject.AddComponent<RigidBody>(RigidBody::Register(1.0f, velocity, glm::vec3{ 0.0f }));
+
+	return gameObject;
+}
+
+// The physics half of a fixed tick in BoulderSmash.cpp, with the ECS update reduced to what it does for physics.
+void Tick()
+{
+	for (GameObject* gameObject : ECSManager::GetGameObjects())
+		gameObject->previousTransform = gameObject->transform;
+
+	PhysicsWorld::Step(tickLength);
+	RigidBodySolver::Step(tickLength);
+}
+
+void Clear()
+{
+	std::vector<EntityID> ids;
+
+	for (GameObject* gameObject : ECSManager::GetGameObjects())
+		ids.push_back(gameObject->GetID());
+
+	for (EntityID id : ids)
+		ECSManager::DestroyGameObject(id);
+}
+
+// At 600 units a second the body moves ten units a tick, five times its distance to a wall a fifth of a unit thick.
+void TestTunneling()
+{
+	AddBox({ 3.0f, -5.0f, -5.0f }, { 0.2f, 10.0f, 10.0f }, false);
+
+	EntityID fast = AddBody({ 1.0f, 0.0f, 0.0f }, { 600.0f, 0.0f, 0.0f }, true).GetID();
+	EntityID missing = AddBody({ 1.0f, 20.0f, 0.0f }, { 600.0f, 0.0f, 0.0f }, true).GetID();
+
+	Tick();
+
+	GameObject& body = *ECSManager::GetGameObject(fast);
+
+	// The wall is found from where the body starts the tick, before the solver has moved it.
+	check(PhysicsWorld::GetPairs().size() == 1 && PhysicsWorld::GetTimeOfImpact(0) > 0.0f && PhysicsWorld::GetTimeOfImpact(0) < 0.2f);
+
+	check(body.transform.position.x + 1.0f <= 3.0f + 1e-3f);
+	check(body.transform.position.x > 1.0f);
+	check(body.GetComponent<RigidBody>().linearVelocity.x < 600.0f);
+
+	for (int i = 0; i < 30; ++i)
+	{
+		Tick();
+		check(body.transform.position.x + 1.0f <= 3.0f + 1e-3f);
+	}
+
+	// A body with nothing in its path keeps its speed.
+	GameObject& other = *ECSManager::GetGameObject(missing);
+
+	check(other.GetComponent<RigidBody>().linearVelocity.x == 600.0f);
+	check(std::abs(other.transform.position.x - (1.0f + 31.0f * 10.0f)) < 1e-2f);
+
+	Clear();
+}
+
+// Two bodies closing on each other from opposite sides inside one tick meet rather than swap places.
+void TestHeadOn()
+{
+	EntityID left = AddBody({ -3.0f, 0.0f, 0.0f }, { 240.0f, 0.0f, 0.0f }, true).GetID();
+	EntityID right = AddBody({ 2.0f, 0.0f, 0.0f }, { -240.0f, 0.0f, 0.0f }, true).GetID();
+
+	Tick();
+
+	GameObject& a = *ECSManager::GetGameObject(left);
+	GameObject& b = *ECSManager::GetGameObject(right);
+
+	check(a.transform.position.x + 1.0f <= b.transform.position.x + 1e-3f);
+	check(std::abs(a.GetComponent<RigidBody>().linearVelocity.x + b.GetComponent<RigidBody>().linearVelocity.x) < 1e-3f);
+
+	Clear();
+}
+
+// Slow bodies still collide through ordinary penetrating contacts and bounce apart.
+void TestDiscreteContact()
+{
+	EntityID left = AddBody({ 0.0f, 0.0f, 0.0f }, { 5.0f, 0.0f, 0.0f }, false).GetID();
+	EntityID right = AddBody({ 1.5f, 0.0f, 0.0f }, { -5.0f, 0.0f, 0.0f }, false).GetID();
+
+	for (int i = 0; i < 60; ++i)
+		Tick();
+
+	check(ECSManager::GetGameObject(left)->GetComponent<RigidBody>().linearVelocity.x < 0.0f);
+	check(ECSManager::GetGameObject(right)->GetComponent<RigidBody>().linearVelocity.x > 0.0f);
+
+	Clear();
+}
+
+int main()
+{
+	TestTunneling();
+	TestHeadOn();
+	TestDiscreteContact();
+
+	return TestHelpers::Finish("RigidBodySolverTests");
+}
@@ -0,0 +1,156 @@
+#include "TestHelpers.hpp"
+#include <cstring>
+#include <string>
+#include <vector>
+#include "rendering/ShaderManager.hpp"
+
+// Compile together with glad.c from the repository root. The reflection calls answer from the fake program below,
+// laid out the way a driver reports it, so no window or context is needed.
+struct FakeUniform
+{
+	std::string name;
+	int size;
+	int location;
+};
+
+std::vector<FakeUniform> activeUniforms =
+{
+	{ "model", 1, 0 },
+	{ "material.shininess", 1, 1 },
+	// An array of a plain type is reported once, as its first element, with the element count as its size.
+	{ "boneWeights[0]", 3, 2 },
+	// An array of structs is reported member by member.
+	{ "pointLights[0].position", 1, 5 },
+	{ "pointLights[1].position", 1, 6 },
+	// Members of a uniform block are active but have no location.
+	{ "Camera.view", 1, -1 }
+};
+
+int locationLookups = 0;
+int lastLocation = -2;
+float lastValue = 0.0f;
+
+void APIENTRY FakeGetProgramiv(GLuint, GLenum parameter, GLint* value)
+{
+	if (parameter == GL_ACTIVE_UNIFORMS)
+		*value = static_cast<GLint>(activeUniforms.size());
+	else if (parameter == GL_ACTIVE_UNIFORM_MAX_LENGTH)
+		*value = 24;
+}
+
+void APIENTRY FakeGetActiveUniform(GLuint, GLuint index, GLsizei bufferSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+	const FakeUniform& uniform = activeUniforms[index];
+
+	*length = static_cast<GLsizei>(std::min<std::size_t>(uniform.name.size(), bufferSize - 1));
+	*size = uniform.size;
+	*type = GL_FLOAT;
+
+	std::memcpy(name, uniform.name.c_str(), *length);
+	name[*length] = '\0';
+}
+
+GLint APIENTRY FakeGetUniformLocation(GLuint, const GLchar* name)
+{
+	locationLookups++;
+
+	for (const FakeUniform& uniform : activeUniforms)
+	{
+		if (uniform.name == name)
+			return uniform.location;
+	}
+
+	// The later elements of boneWeights, which the driver does not list.
+	for (int e = 1; e < 3; ++e)
+	{
+		if (std::string("boneWeights[") + std::to_string(e) + "]" == name)
+			return 2 + e;
+	}
+
+	return -1;
+}
+
+void APIENTRY FakeUniform1f(GLint location, GLfloat value)
+{
+	lastLocation = location;
+	lastValue = value;
+}
+
+void InstallFakes()
+{
+	glad_glGetProgramiv = FakeGetProgramiv;
+	glad_glGetActiveUniform = FakeGetActiveUniform;
+	glad_glGetUniformLocation = FakeGetUniformLocation;
+	glad_glUniform1f = FakeUniform1f;
+}
+
+void TestReflection()
+{
+	ShaderObject shader;
+
+	shader.ID = 1;
+	shader.ReflectUniforms();
+
+	check(shader.GetUniform("model").location == 0);
+	check(shader.GetUniform("material.shininess").location == 1);
+	check(shader.GetUniform("pointLights[0].position").location == 5);
+	check(shader.GetUniform("pointLights[1].position").location == 6);
+
+	// Plain arrays can be reached by their bare name, their first element and every later element.
+	check(shader.GetUniform("boneWeights").location == 2);
+	check(shader.GetUniform("boneWeights[0]").location == 2);
+	check(shader.GetUniform("boneWeights[1]").location == 3);
+	check(shader.GetUniform("boneWeights[2]").location == 4);
+	check(!shader.GetUniform("boneWeights[3]").IsValid());
+
+	// Block members and names the program does not use give an invalid handle.
+	check(!shader.GetUniform("Camera.view").IsValid());
+	check(!shader.GetUniform("projection").IsValid());
+	check(shader.uniforms->size() == 8);
+
+	// A program never reflected has no uniforms rather than failing.
+	ShaderObject unlinked;
+
+	check(!unlinked.GetUniform("model").IsValid());
+}
+
+// After reflection no setter goes back to the driver for a location, whether it takes a handle or a name.
+void TestSettersSkipLookups()
+{
+	ShaderObject shader;
+
+	shader.ID = 1;
+	shader.ReflectUniforms();
+
+	UniformHandle shininess = shader.GetUniform("material.shininess");
+
+	locationLookups = 0;
+
+	shader.SetFloat(shininess, 32.0f);
+	check(lastLocation == 1 && lastValue == 32.0f);
+
+	shader.SetFloat("boneWeights[2]", 0.5f);
+	check(lastLocation == 4 && lastValue == 0.5f);
+
+	// Unknown names resolve to -1, which GL ignores, as a failed glGetUniformLocation would.
+	shader.SetFloat("projection", 1.0f);
+	check(lastLocation == -1);
+
+	// Copies share the reflected table instead of rebuilding it.
+	ShaderObject copy = shader;
+
+	copy.SetFloat("model", 2.0f);
+	check(lastLocation == 0 && copy.uniforms == shader.uniforms);
+
+	check(locationLookups == 0);
+}
+
+int main()
+{
+	InstallFakes();
+
+	TestReflection();
+	TestSettersSkipLookups();
+
+	return TestHelpers::Finish("ShaderObjectTests");
+}
@@ -0,0 +1,135 @@
+#include "TestHelpers.hpp"
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <utility>
+#include "components/BoxCollider.hpp"
+#include "physics/SpatialHashGrid.hpp"
+
+typedef std::set<std::pair<std::uint32_t, std::uint32_t>> PairSet;
+
+// What the grid replaced: every collider tested against every other one.
+PairSet FindPairsByLoop(const std::vector<BoxCollider>& colliders)
+{
+	PairSet pairs;
+
+	for (std::uint32_t a = 0; a < colliders.size(); ++a)
+	{
+		for (std::uint32_t b = a + 1; b < colliders.size(); ++b)
+		{
+			if (colliders[a].IsCollidingWith(colliders[b]))
+				pairs.insert({ a, b });
+		}
+	}
+
+	return pairs;
+}
+
+PairSet FindPairsByGrid(SpatialHashGrid& grid, const std::vector<AABB>& bounds)
+{
+	std::vector<ColliderPair> pairs;
+
+	grid.FindPairs(bounds, pairs);
+
+	PairSet unique;
+
+	for (const ColliderPair& pair : pairs)
+	{
+		check(pair.a < pair.b);
+		unique.insert({ pair.a, pair.b });
+	}
+
+	// The grid must not report a pair twice, even when the boxes share many cells.
+	check(unique.size() == pairs.size());
+
+	return unique;
+}
+
+void Scatter(std::mt19937& random, int count, float worldSize, float maxSize, std::vector<BoxCollider>& colliders, std::vector<AABB>& bounds)
+{
+	std::uniform_real_distribution<float> position(-worldSize * 0.5f, worldSize * 0.5f);
+	std::uniform_real_distribution<float> size(0.25f, maxSize);
+
+	colliders.clear();
+	bounds.clear();
+
+	for (int i = 0; i < count; ++i)
+	{
+		glm::vec3 min{ position(random), position(random), position(random) };
+
+		colliders.push_back(BoxCollider::Register(TRANSFORM_POSITION(min.x, min.y, min.z), glm::vec3{ size(random), size(random), size(random) }, false));
+		bounds.push_back(colliders.back().GetBounds());
+	}
+}
+
+void TestMatchesLoop()
+{
+	std::mt19937 random(11);
+	std::vector<BoxCollider> colliders;
+	std::vector<AABB> bounds;
+	SpatialHashGrid grid(8.0f);
+
+	// Small boxes, boxes spanning dozens of cells, and a crowded world, all straddling the origin where cell coordinates turn negative.
+	Scatter(random, 2000, 400.0f, 6.0f, colliders, bounds);
+	check(FindPairsByGrid(grid, bounds) == FindPairsByLoop(colliders));
+
+	Scatter(random, 500, 200.0f, 40.0f, colliders, bounds);
+	check(FindPairsByGrid(grid, bounds) == FindPairsByLoop(colliders));
+
+	Scatter(random, 1000, 20.0f, 3.0f, colliders, bounds);
+	check(FindPairsByGrid(grid, bounds) == FindPairsByLoop(colliders));
+
+	// Boxes that only touch on a cell boundary do not overlap; identical boxes do.
+	colliders.clear();
+	colliders.push_back(BoxCollider::Register(TRANSFORM_POSITION(0.0f, 0.0f, 0.0f), glm::vec3{ 8.0f }, false));
+	colliders.push_back(BoxCollider::Register(TRANSFORM_POSITION(8.0f, 0.0f, 0.0f), glm::vec3{ 8.0f }, false));
+	colliders.push_back(BoxCollider::Register(TRANSFORM_POSITION(8.0f, 0.0f, 0.0f), glm::vec3{ 8.0f }, false));
+	colliders.push_back(BoxCollider::Register(TRANSFORM_POSITION(-4.0f, -4.0f, -4.0f), glm::vec3{ 8.0f }, false));
+
+	bounds.clear();
+
+	for (const BoxCollider& collider : colliders)
+		bounds.push_back(collider.GetBounds());
+
+	PairSet expected = { { 0, 3 }, { 1, 2 } };
+
+	check(FindPairsByGrid(grid, bounds) == expected);
+	check(FindPairsByLoop(colliders) == expected);
+
+	bounds.clear();
+	check(FindPairsByGrid(grid, bounds).empty());
+}
+
+void MeasureScaling(int largest)
+{
+	std::mt19937 random(3);
+	std::vector<BoxCollider> colliders;
+	std::vector<AABB> bounds;
+	std::vector<ColliderPair> pairs;
+	SpatialHashGrid grid(8.0f);
+
+	std::printf("Broadphase (best of 3, ms), boxes up to 6 units at a constant density: pair loop vs spatial hash\n");
+
+	for (int count = 1000; count <= largest; count *= 2)
+	{
+		// Grow the world with the count, so each box has about as many neighbours at every size.
+		Scatter(random, count, 400.0f * std::cbrt(count / 20000.0f), 6.0f, colliders, bounds);
+
+		std::size_t found = 0;
+
+		double loop = TestHelpers::Measure([&]() { found = FindPairsByLoop(colliders).size(); }, 3);
+		double hashed = TestHelpers::Measure([&]() { grid.FindPairs(bounds, pairs); }, 3);
+
+		check(pairs.size() == found);
+
+		std::printf("  %6d boxes, %5zu pairs: %9.3f vs %7.3f (%.0fx)\n", count, found, loop, hashed, loop / hashed);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	TestMatchesLoop();
+	MeasureScaling(argc > 1 ? std::atoi(argv[1]) : 16000);
+
+	return TestHelpers::Finish("SpatialHashGridTests");
+}
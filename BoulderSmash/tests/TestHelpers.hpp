@@ -0,0 +1,63 @@
+#ifndef TEST_HELPERS_HPP
+#define TEST_HELPERS_HPP
+
+// Windows.h comes in through Logger, and its min/max macros break std::min, as in the game project.
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+// Every file in tests/ is its own console program: compile it alone, with BoulderSmash/include and Libraries/include on the
+// include path, the same way BoulderSmash.cpp pulls in the engine headers. Programs return non-zero when a check fails.
+namespace TestHelpers
+{
+	extern int failures;
+
+	void Check(bool condition, const char* expression, const char* file, int line)
+	{
+		if (condition)
+			return;
+
+		std::printf("FAILED %s:%d: %s\n", file, line, expression);
+		failures++;
+	}
+
+	// Best of repeats, in milliseconds, so one preempted run does not skew a comparison.
+	template<typename Function>
+	double Measure(Function&& function, int repeats = 5)
+	{
+		double best = 1e30;
+
+		for (int r = 0; r < repeats; ++r)
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+
+			function();
+
+			best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+		}
+
+		return best;
+	}
+
+	int Finish(const char* name)
+	{
+		if (failures == 0)
+			std::printf("%s: all checks passed\n", name);
+		else
+			std::printf("%s: %d checks failed\n", name, failures);
+
+		std::fflush(stdout);
+
+		return failures == 0 ? 0 : 1;
+	}
+}
+
+int TestHelpers::failures = 0;
+
+#define check(...) TestHelpers::Check((__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+
+#endif // !TEST_HELPERS_HPP
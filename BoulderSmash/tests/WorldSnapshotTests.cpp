@@ -0,0 +1,256 @@
+#include "TestHelpers.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <tuple>
+#include "core/ECS.hpp"
+#include "core/WorldSnapshot.hpp"
+
+#define snapshotPath "WorldSnapshotTests.bin"
+
+struct Health : Component
+{
+	struct Snapshot
+	{
+		int value;
+	};
+
+	Health(int value = 0) : value(value) { }
+
+	void Start() override
+	{
+		started++;
+	}
+
+	Snapshot SaveSnapshot() const
+	{
+		return { value };
+	}
+
+	void LoadSnapshot(const Snapshot& snapshot)
+	{
+		value = snapshot.value;
+	}
+
+	int value;
+
+	static int started;
+};
+
+int Health::started = 0;
+
+struct Velocity : Component
+{
+	struct Snapshot
+	{
+		glm::vec3 value;
+	};
+
+	Velocity(const glm::vec3& value = glm::vec3{ 0.0f }) : value(value) { }
+
+	Snapshot SaveSnapshot() const
+	{
+		return { value };
+	}
+
+	void LoadSnapshot(const Snapshot& snapshot)
+	{
+		value = snapshot.value;
+	}
+
+	glm::vec3 value;
+};
+
+// Has no Snapshot, so saving leaves it out.
+struct Marker : Component
+{
+};
+
+typedef std::tuple<float, float, float, int, float> EntityRecord;
+
+std::vector<EntityRecord> Describe()
+{
+	std::vector<EntityRecord> records;
+
+	for (GameObject* gameObject : ECSManager::GetGameObjects())
+	{
+		int health = gameObject->HasComponent<Health>() ? gameObject->GetComponent<Health>().value : -1;
+		float velocity = gameObject->HasComponent<Velocity>() ? gameObject->GetComponent<Velocity>().value.y : -1.0f;
+		glm::vec3 position = gameObject->transform.position;
+
+		if (gameObject->HasComponent<Health>())
+			check(gameObject->GetComponent<Health>().gameObject == gameObject);
+
+		records.push_back({ position.x, position.y, position.z, health, velocity });
+	}
+
+	std::sort(records.begin(), records.end());
+
+	return records;
+}
+
+void Clear()
+{
+	std::vector<EntityID> ids;
+
+	for (GameObject* gameObject : ECSManager::GetGameObjects())
+		ids.push_back(gameObject->GetID());
+
+	for (EntityID id : ids)
+		ECSManager::DestroyGameObject(id);
+}
+
+// Entities spread over three archetypes; one in four also holds a Marker, which gives it a fourth archetype on save.
+void BuildWorld(int count)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		GameObject& gameObject = ECSManager::AddGameObject();
+
+		gameObject.Teleport(TRANSFORM_POSITION(static_cast<float>(i), 2.0f, -static_cast<float>(i)));
+
+		if (i % 3 != 2)
+			gameObject.AddComponent<Health>(i);
+
+		if (i % 3 != 0)
+			gameObject.AddComponent<Velocity>(glm::vec3{ 0.0f, static_cast<float>(i) * 0.5f, 0.0f });
+
+		if (i % 4 == 0)
+			gameObject.AddComponent<Marker>();
+	}
+}
+
+std::vector<char> ReadFile()
+{
+	std::ifstream file(snapshotPath, std::ios::binary);
+
+	return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void WriteFile(const std::vector<char>& bytes, std::size_t size)
+{
+	std::ofstream file(snapshotPath, std::ios::binary | std::ios::trunc);
+
+	file.write(bytes.data(), size);
+}
+
+void TestRoundTrip()
+{
+	BuildWorld(1000);
+
+	std::vector<EntityRecord> saved = Describe();
+
+	check(WorldSnapshot::Save(snapshotPath));
+
+	Clear();
+	Health::started = 0;
+
+	check(WorldSnapshot::Load(snapshotPath));
+	check(Describe() == saved);
+	check(Health::started == 667);
+	check(ECSManager::Query<Marker>().Size() == 0);
+
+	// Loading twice appends a second copy of the world.
+	check(WorldSnapshot::Load(snapshotPath));
+	check(ECSManager::GetGameObjects().size() == 2000);
+
+	Clear();
+}
+
+void TestCorruptFiles()
+{
+	for (int i = 0; i < 6; ++i)
+	{
+		GameObject& gameObject = ECSManager::AddGameObject();
+
+		gameObject.AddComponent<Health>(i);
+		gameObject.AddComponent<Velocity>();
+	}
+
+	check(WorldSnapshot::Save(snapshotPath));
+	Clear();
+
+	std::vector<char> bytes = ReadFile();
+
+	// Every cut, including one inside the last component array, must be refused without adding anything.
+	for (std::size_t size = 0; size < bytes.size(); size += 7)
+	{
+		WriteFile(bytes, size);
+
+		check(!WorldSnapshot::Load(snapshotPath));
+		check(ECSManager::GetGameObjects().empty());
+	}
+
+	WriteFile(bytes, bytes.size() - 1);
+	check(!WorldSnapshot::Load(snapshotPath));
+
+	std::vector<char> corrupt = bytes;
+
+	corrupt[0] ^= 0x40;
+	WriteFile(corrupt, corrupt.size());
+	check(!WorldSnapshot::Load(snapshotPath));
+
+	corrupt = bytes;
+	corrupt[4] = 99;
+	WriteFile(corrupt, corrupt.size());
+	check(!WorldSnapshot::Load(snapshotPath));
+
+	corrupt = bytes;
+	corrupt.push_back(0);
+	WriteFile(corrupt, corrupt.size());
+	check(!WorldSnapshot::Load(snapshotPath));
+
+	// The one block holds Health and Velocity; writing the first hash over the second names one column twice.
+	corrupt = bytes;
+	std::copy(corrupt.begin() + 20, corrupt.begin() + 28, corrupt.begin() + 28);
+	WriteFile(corrupt, corrupt.size());
+	check(!WorldSnapshot::Load(snapshotPath));
+
+	check(ECSManager::GetGameObjects().empty());
+
+	WriteFile(bytes, bytes.size());
+	check(WorldSnapshot::Load(snapshotPath));
+	check(ECSManager::GetGameObjects().size() == 6);
+
+	Clear();
+}
+
+void MeasureLoad(int count)
+{
+	BuildWorld(count);
+
+	double save = TestHelpers::Measure([]() { WorldSnapshot::Save(snapshotPath); }, 3);
+
+	Clear();
+
+	double load = TestHelpers::Measure([]()
+	{
+		WorldSnapshot::Load(snapshotPath);
+		Clear();
+	}, 3);
+
+	// What loading cost before: one GameObject at a time, every component moving it to another archetype.
+	double individually = TestHelpers::Measure([count]()
+	{
+		BuildWorld(count);
+		Clear();
+	}, 3);
+
+	std::printf("%d entities: save %.2f ms, load %.2f ms, building them one by one %.2f ms\n", count, save, load, individually);
+}
+
+int main(int argc, char** argv)
+{
+	GetComponentTypeID<Health>();
+	GetComponentTypeID<Velocity>();
+
+	TestRoundTrip();
+	TestCorruptFiles();
+
+	MeasureLoad(argc > 1 ? std::atoi(argv[1]) : 100000);
+
+	std::remove(snapshotPath);
+
+	return TestHelpers::Finish("WorldSnapshotTests");
+}